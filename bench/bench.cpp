@@ -0,0 +1,928 @@
+// bench.cpp — mesures sans fenêtre visible, résultats en JSON (make bench)
+//
+// Usage : origamix_bench [--out fichier.json] [--commit id] [--iterations n]
+// Le rendu passe par le pilote SDL "offscreen" (ou "dummy") ; sans contexte GL,
+// le cas frame/submit est marqué "skipped" au lieu de faire échouer la suite.
+#include "asset_loader.hpp"
+#include "objx.hpp"
+#include "scene.hpp"
+#include "texture.hpp"
+#include "texture_streamer.hpp"
+#include "gpu_mesh.hpp"
+#include "mesh_binary.hpp"
+#include "mesh_lod.hpp"
+#include "mesh_text.hpp"
+#include "outline.hpp"
+#include "pick_grid.hpp"
+#include "render_thread.hpp"
+#include "thread_pool.hpp"
+#include "vertex_quant.hpp"
+#include "world.hpp"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_opengles2.h>
+#include <zip.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const char* GROUND_ARCHIVE = "assets/ground.plxl";
+static const char* MAISON_PNG = "assets/maison.png";
+static const char* TEMP_DIR = "build/bench_temp";
+static const int SYNTHETIC_SURFACES = 64;
+static const int SYNTHETIC_GRID = 32; // quads par côté et par surface
+static const int FRAME_WIDTH = 800, FRAME_HEIGHT = 600;
+static const size_t PICK_CLOUDS[] = {1000, 10000, 100000}; // sommets du découpage synthétique
+static const int PICK_QUERIES = 10000;
+static const float PICK_SPACING = 8.0f; // pixels entre sommets voisins, avant perturbation
+static const int TILESET_SIZE = 2048, TILE_SIZE = 64; // planche synthétique : un anneau par tuile
+static const int LOD_GRID = 256; // terrain ondulé pour les niveaux de détail
+static const int MESH_TEXT_SURFACES = 200, MESH_TEXT_VERTICES = 10000; // 2 millions de lignes "v"
+static const int MESH_TEXT_ITERATIONS = 3; // une lecture getline/istringstream dure plusieurs secondes
+static const int PACING_FRAMES = 120;
+static const int PACING_IO_EVERY = 30; // frames entre deux sauvegardes + relectures, en mono-thread
+static const chrono::nanoseconds PACING_PERIOD(1000000000 / 60);
+static const int WORLD_TILES = 16;          // archives posées par côté, une surface et un chunk chacune
+static const float WORLD_CHUNK = 2.0f;      // = pas de la grille : 256 chunks
+static const size_t WORLD_MAX_RESIDENT = 24;
+static const int WORLD_FRAMES = 240;        // traversée du monde à 60 Hz, puis vue d'ensemble
+static const int STARTUP_ARCHIVES = 16;     // copies de ground et de l'archive synthétique : de quoi occuper les cœurs
+
+struct Result {
+    string name;
+    vector<double> ms; // une durée par itération
+    string skipped;    // raison, si le cas n'a pas pu tourner
+    map<string, double> extra;
+};
+
+// Les journaux de Objx::open/save vont à la poubelle pendant les mesures
+class Silence {
+public:
+    Silence() : out(cout.rdbuf(nullptr)), err(cerr.rdbuf(nullptr)) {}
+    ~Silence() {
+        cout.rdbuf(out);
+        cerr.rdbuf(err);
+    }
+
+private:
+    streambuf* out;
+    streambuf* err;
+};
+
+static Result measure(const string& name, int iterations, const function<void()>& work) {
+    Result r{name, {}, "", {}};
+    {
+        Silence s;
+        work(); // échauffement : caches disque et allocateur
+        for (int i = 0; i < iterations; ++i) {
+            auto debut = chrono::steady_clock::now();
+            work();
+            r.ms.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - debut).count());
+        }
+    }
+    return r;
+}
+
+static double medianMs(const Result& r) {
+    vector<double> tri = r.ms;
+    sort(tri.begin(), tri.end());
+    return tri.empty() ? 0.0 : tri[tri.size() / 2];
+}
+
+// Grille plane découpée en surfaces, indexée comme après Objx::open
+static Objx syntheticObjx() {
+    Objx px;
+    px.getSurfaces().clear();
+    for (int s = 0; s < SYNTHETIC_SURFACES; ++s) {
+        Surfaces surf;
+        surf.texture = MAISON_PNG;
+        float ox = (float)(s % 8), oy = (float)(s / 8);
+        for (int y = 0; y <= SYNTHETIC_GRID; ++y) {
+            for (int x = 0; x <= SYNTHETIC_GRID; ++x) {
+                float u = (float)x / SYNTHETIC_GRID, v = (float)y / SYNTHETIC_GRID;
+                surf.points.push_back({ox + u, oy + v, 0.0f, u, v});
+            }
+        }
+        uint32_t row = SYNTHETIC_GRID + 1;
+        for (uint32_t y = 0; y < (uint32_t)SYNTHETIC_GRID; ++y) {
+            for (uint32_t x = 0; x < (uint32_t)SYNTHETIC_GRID; ++x) {
+                uint32_t i = y * row + x;
+                surf.indices.insert(surf.indices.end(), {i, i + 1, i + row, i + 1, i + row + 1, i + row});
+            }
+        }
+        px.addSurface(surf);
+    }
+    px.updateBounds();
+    return px;
+}
+
+static size_t triangleCount(const Objx& px) {
+    size_t n = 0;
+    for (const auto& s : px.getSurfaces()) n += s.cornerCount() / 3;
+    return n;
+}
+
+static void benchArchive(vector<Result>& results, const string& label, const string& path, int iterations) {
+    if (!fs::exists(path)) {
+        results.push_back({"open/" + label, {}, "fichier absent : " + path, {}});
+        return;
+    }
+    Result open = measure("open/" + label, iterations, [&]() { Objx::open(path); });
+    Objx px;
+    {
+        Silence s;
+        px = Objx::open(path);
+    }
+    open.extra["surfaces"] = (double)px.getSurfaces().size();
+    open.extra["triangles"] = (double)triangleCount(px);
+    results.push_back(open);
+
+    // Décodage des PNG embarqués, fait par TextureStreamer sur le pool dans le viewer
+    vector<Blob> pngs;
+    set<string> vus;
+    for (const auto& s : px.getSurfaces()) {
+        string name = fs::path(s.texture).filename().string();
+        const Blob* png = px.getEmbedded(name);
+        if (png && vus.insert(name).second) pngs.push_back(*png);
+    }
+    Result decode = measure("texture_decode/" + label, iterations, [&]() {
+        for (const auto& png : pngs) {
+            ImageRGBA img;
+            decodeImage(png, img);
+        }
+    });
+    decode.extra["textures"] = (double)pngs.size();
+    results.push_back(decode);
+
+    Result str = measure("to_string/" + label, iterations, [&]() { px.toString(); });
+    results.push_back(str);
+}
+
+// Objx::save d'avant l'écriture incrémentale, comme référence : textures recopiées dans un dossier
+// temporaire, mesh écrit à côté, puis tout zippé en deflate par défaut (PNG recompressés). Même coût
+// que rien n'ait bougé ou non : l'archive est toujours réécrite entièrement.
+static bool legacySave(const Objx& px, const string& zipPath, MeshFormat format) {
+    string tempFolder = string(TEMP_DIR) + "/export_temp/";
+    fs::create_directories(tempFolder);
+    set<string> copied;
+    for (const auto& s : px.getSurfaces()) {
+        if (s.texture.empty()) continue;
+        fs::path texPath = s.texture;
+        string filename = texPath.filename().string();
+        if (!copied.insert(filename).second) continue;
+        const Blob* embarque = px.getEmbedded(filename);
+        Blob png = embarque ? *embarque : Blob::fromFile(texPath.string());
+        ofstream(tempFolder + filename, ios::binary).write(reinterpret_cast<const char*>(png.data), png.size);
+    }
+    if (format == MeshFormat::Binary) {
+        vector<unsigned char> bin = writeMeshBinary(px.getSurfaces());
+        ofstream(tempFolder + "map.meshb", ios::binary).write(reinterpret_cast<const char*>(bin.data()), bin.size());
+    } else {
+        ofstream out(tempFolder + "map.mesh");
+        for (const auto& s : px.getSurfaces()) {
+            out << "texture=" << fs::path(s.texture).filename().string() << "\n";
+            for (size_t i = 0; i < s.cornerCount(); ++i) {
+                const Point5D& p = s.corner(i);
+                out << "v " << p.x << " " << p.y << " " << p.z << " " << p.u << " " << p.v << "\n";
+            }
+            out << "\n";
+        }
+    }
+
+    int err = 0;
+    zip_t* archive = zip_open(zipPath.c_str(), ZIP_CREATE | ZIP_TRUNCATE, &err);
+    if (!archive) return false;
+    for (const auto& entry : fs::directory_iterator(tempFolder)) {
+        zip_source_t* source = zip_source_file(archive, entry.path().string().c_str(), 0, 0);
+        if (!source || zip_file_add(archive, entry.path().filename().string().c_str(), source, ZIP_FL_OVERWRITE) < 0) {
+            if (source) zip_source_free(source);
+        }
+    }
+    bool ok = zip_close(archive) == 0;
+    fs::remove_all(tempFolder);
+    return ok;
+}
+
+static void benchSave(vector<Result>& results, Objx& px, const string& label, const SaveOptions& options, int iterations) {
+    string base = string(TEMP_DIR) + "/" + label;
+    string path = base + ".objx"; // save ajoute l'extension
+    string name = string("save/") + label + (options.mesh == MeshFormat::Binary ? "/meshb" : "/mesh");
+
+    // Archive neuve à chaque fois : tout est écrit
+    Result full = measure(name, iterations, [&]() {
+        fs::remove(path);
+        px.setEmplacement(base);
+        px.save(options);
+    });
+    full.extra["bytes"] = fs::exists(path) ? (double)fs::file_size(path) : 0.0;
+
+    // Avant : même sauvegarde par l'ancien chemin, à comparer aux trois cas ci-dessous
+    bool avecLegacy = !options.aligned && !options.quantize && !options.etc1;
+    Result legacy;
+    if (avecLegacy) {
+        string legacyPath = base + "_legacy.objx";
+        legacy = measure(name + "/legacy", iterations, [&]() { legacySave(px, legacyPath, options.mesh); });
+        legacy.extra["bytes"] = fs::exists(legacyPath) ? (double)fs::file_size(legacyPath) : 0.0;
+    }
+
+    // Archive existante, rien n'a bougé : seules les comparaisons de CRC restent
+    Result unchanged = measure(name + "/unchanged", iterations, [&]() { px.save(options); });
+
+    // Un sommet déplacé : seule l'entrée mesh est réécrite
+    Surfaces& s = px.getSurfaces().back();
+    Result oneVertex = measure(name + "/one_vertex", iterations, [&]() {
+        s.points[0].z += 0.001f;
+        ++s.revision;
+        px.save(options);
+    });
+
+    // Gain de chaque cas sur l'ancien chemin (médianes), dans le JSON et résumé sur stderr
+    if (avecLegacy) {
+        double avant = medianMs(legacy);
+        cerr << "[bench] " << name << " : legacy " << avant << " ms";
+        const pair<const char*, Result*> cas[] = {{"full", &full}, {"unchanged", &unchanged}, {"one_vertex", &oneVertex}};
+        for (const auto& [nom, r] : cas) {
+            double apres = medianMs(*r);
+            if (apres > 0) r->extra["speedup_vs_legacy"] = avant / apres;
+            cerr << ", " << nom << " " << apres << " ms";
+        }
+        cerr << endl;
+    }
+    results.push_back(full);
+    if (avecLegacy) results.push_back(legacy);
+    results.push_back(unchanged);
+    results.push_back(oneVertex);
+}
+
+// Démarrage du viewer sans GL : loadAssets puis décodage et mipmaps des PNG embarqués, comme
+// TextureStreamer, sur un pool de 1, 2, 4… threads jusqu'au nombre de cœurs
+static void benchStartup(vector<Result>& results, int iterations) {
+    vector<string> sources = {GROUND_ARCHIVE, string(TEMP_DIR) + "/synthetic.objx"};
+    vector<string> paths;
+    for (int i = 0; i < STARTUP_ARCHIVES; ++i) {
+        const string& source = sources[i % sources.size()];
+        string path = string(TEMP_DIR) + "/startup_" + to_string(i) + fs::path(source).extension().string();
+        error_code ec;
+        fs::copy_file(source, path, fs::copy_options::overwrite_existing, ec);
+        if (!ec) paths.push_back(path);
+    }
+    if (paths.empty()) {
+        results.push_back({"startup", {}, "archives introuvables", {}});
+        return;
+    }
+
+    unsigned coeurs = max(1u, thread::hardware_concurrency());
+    vector<unsigned> tailles;
+    for (unsigned n = 1; n < coeurs; n *= 2) tailles.push_back(n);
+    tailles.push_back(coeurs);
+
+    for (unsigned n : tailles) {
+        ThreadPool pool(n);
+        size_t textures = 0;
+        Result r = measure("startup/threads_" + to_string(n), iterations, [&]() {
+            vector<Objx> objxs = loadAssets(paths, pool);
+            vector<future<void>> decodes;
+            textures = 0;
+            for (const auto& px : objxs) {
+                set<string> vus;
+                for (const auto& s : px.getSurfaces()) {
+                    string name = fs::path(s.texture).filename().string();
+                    const Blob* png = px.getEmbedded(name);
+                    if (!png || !vus.insert(name).second) continue;
+                    Blob bytes = *png;
+                    decodes.push_back(pool.submit([bytes]() {
+                        ImageRGBA img;
+                        if (decodeImage(bytes, img)) buildMipChain(std::move(img));
+                    }));
+                    ++textures;
+                }
+            }
+            for (auto& f : decodes) f.get();
+        });
+        r.extra["threads"] = n;
+        r.extra["archives"] = (double)paths.size();
+        r.extra["textures"] = (double)textures;
+        results.push_back(r);
+    }
+}
+
+// Nuage de points du découpage : grille perturbée de n sommets, deux triangles par case
+static void syntheticCloud(size_t n, vector<Point5D>& points, vector<uint32_t>& indices, mt19937& rng) {
+    uint32_t side = (uint32_t)ceil(sqrt((double)n));
+    uniform_real_distribution<float> jitter(-0.3f * PICK_SPACING, 0.3f * PICK_SPACING);
+    points.clear();
+    indices.clear();
+    for (uint32_t y = 0; y < side; ++y) {
+        for (uint32_t x = 0; x < side; ++x) {
+            points.push_back({x * PICK_SPACING + jitter(rng), y * PICK_SPACING + jitter(rng), 0.0f, 0.0f, 0.0f});
+        }
+    }
+    for (uint32_t y = 0; y + 1 < side; ++y) {
+        for (uint32_t x = 0; x + 1 < side; ++x) {
+            uint32_t i = y * side + x;
+            indices.insert(indices.end(), {i, i + 1, i + side, i + 1, i + side + 1, i + side});
+        }
+    }
+}
+
+// Survol et clic droit du découpage : grille contre parcours linéaire, à tailles croissantes
+static void benchPicking(vector<Result>& results, int iterations) {
+    for (size_t n : PICK_CLOUDS) {
+        mt19937 rng(1234);
+        vector<Point5D> points;
+        vector<uint32_t> indices;
+        syntheticCloud(n, points, indices, rng);
+        float extent = sqrt((float)points.size()) * PICK_SPACING;
+        uniform_real_distribution<float> pos(0.0f, extent);
+        vector<pair<float, float>> queries;
+        for (int i = 0; i < PICK_QUERIES; ++i) queries.emplace_back(pos(rng), pos(rng));
+        string suffix = "/" + to_string(points.size());
+
+        PickGrid grid;
+        Result build = measure("pick/build" + suffix, iterations, [&]() {
+            grid.clear(); // ajout un à un, comme au fil des clics
+            for (size_t i = 0; i < points.size(); ++i) grid.addPoint((uint32_t)i, points[i]);
+            for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+                grid.addTriangle((uint32_t)(i / 3), points[indices[i]], points[indices[i + 1]], points[indices[i + 2]]);
+            }
+        });
+        build.extra["cells"] = (double)grid.cellCount();
+        build.extra["triangles"] = (double)(indices.size() / 3);
+        results.push_back(build);
+
+        size_t trouves = 0;
+        Result nearest = measure("pick/nearest" + suffix, iterations, [&]() {
+            trouves = 0;
+            for (auto [x, y] : queries) trouves += grid.nearestPoint(points, x, y, 10.0f) >= 0;
+        });
+        nearest.extra["queries"] = PICK_QUERIES;
+        nearest.extra["hits"] = (double)trouves;
+        results.push_back(nearest);
+
+        // Ancien survol : premier sommet à moins du rayon, tous les sommets parcourus
+        Result linear = measure("pick/nearest_linear" + suffix, iterations, [&]() {
+            trouves = 0;
+            for (auto [x, y] : queries) {
+                for (size_t i = 0; i < points.size(); ++i) {
+                    float dx = points[i].x - x, dy = points[i].y - y;
+                    if (sqrt(dx * dx + dy * dy) < 10.0f) {
+                        ++trouves;
+                        break;
+                    }
+                }
+            }
+        });
+        linear.extra["queries"] = PICK_QUERIES;
+        linear.extra["hits"] = (double)trouves;
+        results.push_back(linear);
+
+        vector<uint32_t> picked;
+        Result triangle = measure("pick/triangle" + suffix, iterations, [&]() {
+            picked.clear();
+            for (auto [x, y] : queries) grid.trianglesAt(points, indices, x, y, picked);
+        });
+        triangle.extra["queries"] = PICK_QUERIES;
+        triangle.extra["hits"] = (double)picked.size();
+        results.push_back(triangle);
+    }
+}
+
+// Contour automatique (Ctrl+N) : une image réelle et une grande planche de sprites
+static void benchOutline(vector<Result>& results, int iterations) {
+    auto run = [&](const string& name, const ImageRGBA& img) {
+        Surfaces s;
+        OutlineStats stats;
+        Result r = measure(name, iterations, [&]() { outlineSurface(img, s, OutlineOptions(), &stats); });
+        r.extra["contours"] = (double)stats.contours;
+        r.extra["holes"] = (double)stats.holes;
+        r.extra["triangles"] = (double)stats.triangles;
+        results.push_back(r);
+    };
+
+    ImageRGBA maison;
+    if (decodeImageFile(MAISON_PNG, maison)) run("outline/maison.png", maison);
+    else results.push_back({"outline/maison.png", {}, string("fichier absent : ") + MAISON_PNG, {}});
+
+    ImageRGBA tileset;
+    tileset.w = tileset.h = TILESET_SIZE;
+    tileset.pixels.assign((size_t)TILESET_SIZE * TILESET_SIZE * 4, 0);
+    for (int y = 0; y < TILESET_SIZE; ++y) {
+        for (int x = 0; x < TILESET_SIZE; ++x) {
+            float dx = x % TILE_SIZE - TILE_SIZE / 2, dy = y % TILE_SIZE - TILE_SIZE / 2;
+            float r = sqrt(dx * dx + dy * dy) / (TILE_SIZE / 2);
+            if (r < 0.85f && r > 0.3f) tileset.pixels[((size_t)y * TILESET_SIZE + x) * 4 + 3] = 255;
+        }
+    }
+    run("outline/tileset_" + to_string(TILESET_SIZE), tileset);
+}
+
+// Niveaux de détail : terrain ondulé (l'erreur borne la réduction) et grille plane de l'objet synthétique
+static void benchLod(vector<Result>& results, int iterations) {
+    Surfaces terrain;
+    uint32_t row = LOD_GRID + 1;
+    for (int y = 0; y <= LOD_GRID; ++y) {
+        for (int x = 0; x <= LOD_GRID; ++x) {
+            float u = (float)x / LOD_GRID, v = (float)y / LOD_GRID;
+            terrain.points.push_back({u, v, 0.05f * sin(u * 12) * cos(v * 9), u, v});
+        }
+    }
+    for (uint32_t y = 0; y < (uint32_t)LOD_GRID; ++y) {
+        for (uint32_t x = 0; x < (uint32_t)LOD_GRID; ++x) {
+            uint32_t i = y * row + x;
+            terrain.indices.insert(terrain.indices.end(), {i, i + 1, i + row, i + 1, i + row + 1, i + row});
+        }
+    }
+    Surfaces plane = syntheticObjx().getSurfaces().front();
+
+    auto run = [&](const string& name, Surfaces& s) {
+        Result r = measure(name, iterations, [&]() { buildLods(s); });
+        r.extra["triangles"] = (double)(s.indices.size() / 3);
+        for (size_t l = 0; l < s.lods.size(); ++l) r.extra["level" + to_string(l + 1)] = (double)(s.lods[l].size() / 3);
+        results.push_back(r);
+    };
+    run("lod/terrain_" + to_string(LOD_GRID), terrain);
+    run("lod/plane_" + to_string(SYNTHETIC_GRID), plane);
+}
+
+// Lecture d'avant readMeshText, gardée comme référence
+static void legacyMeshText(const string& texte, vector<Surfaces>& out) {
+    istringstream in(texte);
+    string line;
+    Surfaces surf;
+    while (getline(in, line)) {
+        if (line.empty()) {
+            if (!surf.points.empty()) out.push_back(surf);
+            surf = Surfaces();
+            continue;
+        }
+        if (line.rfind("texture=", 0) == 0) {
+            surf.texture = line.substr(8);
+        } else if (line[0] == 'v') {
+            istringstream ss(line.substr(2));
+            float x, y, z, u, v;
+            ss >> x >> y >> z >> u >> v;
+            surf.points.push_back({x, y, z, u, v});
+        }
+    }
+    if (!surf.points.empty()) out.push_back(surf);
+}
+
+static bool sameSurfaces(const vector<Surfaces>& a, const vector<Surfaces>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].texture != b[i].texture || a[i].points.size() != b[i].points.size()) return false;
+        if (memcmp(a[i].points.data(), b[i].points.data(), a[i].points.size() * sizeof(Point5D)) != 0) return false;
+    }
+    return true;
+}
+
+// Ancien format texte sur plusieurs millions de sommets, écrit comme meshVersTexte
+static void benchMeshText(vector<Result>& results, int iterations) {
+    mt19937 rng(7);
+    uniform_real_distribution<float> coord(-1000.0f, 1000.0f), uv(0.0f, 1.0f);
+    ostringstream out;
+    for (int s = 0; s < MESH_TEXT_SURFACES; ++s) {
+        out << "texture=surface_" << s << ".png\n";
+        for (int i = 0; i < MESH_TEXT_VERTICES; ++i) {
+            out << "v " << coord(rng) << " " << coord(rng) << " " << coord(rng) << " " << uv(rng) << " " << uv(rng) << "\n";
+        }
+        out << "\n";
+    }
+    string texte = out.str();
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(texte.data());
+
+    vector<Surfaces> reference, lues;
+    iterations = min(iterations, MESH_TEXT_ITERATIONS);
+    Result legacy = measure("mesh_text/legacy", iterations, [&]() {
+        reference.clear();
+        legacyMeshText(texte, reference);
+    });
+    Result parallel = measure("mesh_text/from_chars", iterations, [&]() {
+        lues.clear();
+        readMeshText(data, texte.size(), lues);
+    });
+    for (Result* r : {&legacy, &parallel}) {
+        r->extra["vertices"] = (double)MESH_TEXT_SURFACES * MESH_TEXT_VERTICES;
+        r->extra["bytes"] = (double)texte.size();
+    }
+    parallel.extra["identical"] = sameSurfaces(reference, lues) ? 1 : 0;
+    results.push_back(legacy);
+    results.push_back(parallel);
+}
+
+// Sommets 16 bits contre floats : erreur de chaque composante rapportée à sa borne, extent / 131070
+// plus deux ulps à l'échelle de la boîte (calcul min + q * extent en float, comme dans le shader)
+static void benchQuantize(vector<Result>& results, int iterations, const Objx& synthetique) {
+    vector<Surfaces> surfaces = synthetique.getSurfaces();
+    if (fs::exists(GROUND_ARCHIVE)) {
+        Silence s;
+        for (const auto& surf : Objx::open(GROUND_ARCHIVE).getSurfaces()) surfaces.push_back(surf);
+    }
+    Surfaces loin; // grandes coordonnées, UV répétées hors de [0,1]
+    mt19937 rng(11);
+    uniform_real_distribution<float> coord(-5000.0f, 5000.0f), uv(-3.0f, 3.0f);
+    for (int i = 0; i < 100000; ++i) loin.points.push_back({coord(rng), coord(rng), 0.0f, uv(rng), uv(rng)});
+    surfaces.push_back(loin);
+
+    size_t points = 0;
+    double pire = 0;
+    for (const auto& surf : surfaces) {
+        Dequantization d = Dequantization::of(surf.points);
+        vector<PackedVertex> q = quantize(surf.points, d);
+        for (size_t i = 0; i < q.size(); ++i) {
+            const Point5D& a = surf.points[i];
+            Point5D b = dequantize(q[i], d);
+            const float va[5] = {a.x, a.y, a.z, a.u, a.v}, vb[5] = {b.x, b.y, b.z, b.u, b.v};
+            for (int c = 0; c < 5; ++c) {
+                float debut = c < 3 ? d.posMin[c] : d.uvMin[c - 3], etendue = c < 3 ? d.posExtent[c] : d.uvExtent[c - 3];
+                float grandeur = max(fabs(debut), fabs(debut + etendue));
+                double borne = d.maxError(c) + 2 * (nextafter(grandeur, INFINITY) - grandeur);
+                pire = max(pire, fabs((double)va[c] - vb[c]) / borne);
+            }
+        }
+        points += surf.points.size();
+    }
+
+    Result r = measure("vertex/quantize", iterations, [&]() {
+        for (const auto& surf : surfaces) quantize(surf.points, Dequantization::of(surf.points));
+    });
+    r.extra["points"] = (double)points;
+    r.extra["bytes_float"] = (double)(points * sizeof(Point5D));
+    r.extra["bytes_packed"] = (double)(points * sizeof(PackedVertex));
+    r.extra["max_error_ratio"] = pire; // <= 1 : dans la borne
+    r.extra["within_bound"] = pire <= 1.0 ? 1 : 0;
+    results.push_back(r);
+}
+
+static Result pacingResult(const string& name, const vector<double>& intervals) {
+    Result r{name, intervals, "", {}};
+    double mean = 0, var = 0;
+    for (double d : intervals) mean += d;
+    mean /= intervals.size();
+    size_t late = 0;
+    for (double d : intervals) {
+        var += (d - mean) * (d - mean);
+        late += d > 1.5 * chrono::duration<double, milli>(PACING_PERIOD).count();
+    }
+    r.extra["stddev_ms"] = sqrt(var / intervals.size());
+    r.extra["late_frames"] = (double)late;
+    return r;
+}
+
+// Régularité des frames pendant des sauvegardes et relectures dans la même boucle (viewer d'avant
+// RenderThread). Mesure les intervalles entre débuts de frames, sans GL ; voir benchRenderThread.
+static void benchFramePacing(vector<Result>& results, Objx px) {
+    string path = string(TEMP_DIR) + "/pacing.objx";
+    px.setEmplacement(path);
+    Silence silence;
+    vector<double> intervals;
+    FramePacer pacer(PACING_PERIOD);
+    auto last = chrono::steady_clock::now();
+    for (int f = 0; f < PACING_FRAMES; ++f) {
+        if (f % PACING_IO_EVERY == PACING_IO_EVERY - 1) {
+            px.save();
+            Objx::open(path);
+        }
+        pacer.wait();
+        auto now = chrono::steady_clock::now();
+        intervals.push_back(chrono::duration<double, milli>(now - last).count());
+        last = now;
+    }
+    results.push_back(pacingResult("frame_pacing/single_thread", intervals));
+}
+
+static GLuint benchProgram() {
+    // Transformation du viewer sans les rotations : même nombre d'attributs et de varyings
+    const char* vs = R"(
+        #version 100
+        attribute vec4 vPosition;
+        attribute vec2 aTexCoord;
+        varying vec2 vTexCoord;
+        uniform float scale;
+        void main() {
+            gl_Position = vec4(vPosition.xy * scale, vPosition.z * scale, vPosition.z + 2.0);
+            vTexCoord = aTexCoord;
+        }
+    )";
+    const char* fsrc = R"(
+        #version 100
+        precision mediump float;
+        uniform sampler2D tex;
+        varying vec2 vTexCoord;
+        void main() { gl_FragColor = texture2D(tex, vTexCoord); }
+    )";
+    GLuint program = glCreateProgram();
+    for (auto [type, src] : {make_pair(GL_VERTEX_SHADER, vs), make_pair(GL_FRAGMENT_SHADER, fsrc)}) {
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &src, nullptr);
+        glCompileShader(shader);
+        glAttachShader(program, shader);
+    }
+    glBindAttribLocation(program, 0, "vPosition");
+    glBindAttribLocation(program, 1, "aTexCoord");
+    glLinkProgram(program);
+    return program;
+}
+
+// Monde de WORLD_TILES² tuiles à une surface de l'objet synthétique, une par chunk
+static string buildBenchWorld(vector<Result>& results, const Objx& synthetique) {
+    Objx tuile = synthetique;
+    tuile.getSurfaces().resize(1);
+    tuile.setEmplacement(string(TEMP_DIR) + "/tuile.objx");
+    string dir = string(TEMP_DIR) + "/bench.world";
+    vector<PlacedObjx> instances;
+    for (int y = 0; y < WORLD_TILES; ++y) {
+        for (int x = 0; x < WORLD_TILES; ++x) instances.push_back({tuile.getEmplacement(), x * WORLD_CHUNK, y * WORLD_CHUNK});
+    }
+    bool ok = false;
+    Result r = measure("world/build", 1, [&]() {
+        ok = tuile.save() && buildWorld(instances, WORLD_CHUNK, dir);
+    });
+    if (!ok) {
+        results.push_back({"world/build", {}, "construction impossible", {}});
+        return "";
+    }
+    r.extra["instances"] = (double)instances.size();
+    results.push_back(r);
+    return dir;
+}
+
+// Vue qui traverse le monde puis le montre en entier : les chunks en mémoire (chargés ou en lecture)
+// ne doivent jamais dépasser le budget, et ce qui est quitté doit être rendu
+static void benchWorldStream(vector<Result>& results, const string& dir, ThreadPool& pool, TextureStreamer& textures,
+                             Scene& scene) {
+    if (dir.empty()) {
+        results.push_back({"world/stream", {}, "pas de monde", {}});
+        return;
+    }
+    size_t avant = scene.objectCount();
+    Result r{"world/stream", {}, "", {}};
+    size_t pic = 0, charges = 0;
+    {
+        Silence s;
+        WorldStreamer streamer(dir, pool, scene, WORLD_MAX_RESIDENT);
+        FramePacer pacer(PACING_PERIOD);
+        float largeur = WORLD_TILES * WORLD_CHUNK;
+        for (int f = 0; f < WORLD_FRAMES + 60; ++f) {
+            ViewParams view;
+            if (f < WORLD_FRAMES) { // environ 4 x 3 chunks à l'écran, de gauche à droite au milieu du monde
+                view.scale = 0.5f;
+                view.offsetX = -(largeur * f / WORLD_FRAMES) * view.scale;
+                view.offsetY = -(largeur * 0.5f) * view.scale;
+            } else {               // tout le monde dans le champ
+                view.scale = 3.0f / largeur;
+                view.offsetX = view.offsetY = -(largeur * 0.5f) * view.scale;
+            }
+            auto debut = chrono::steady_clock::now();
+            size_t resident = streamer.residentCount();
+            streamer.update(view);
+            charges += streamer.residentCount() > resident ? streamer.residentCount() - resident : 0;
+            textures.update(SIZE_MAX);
+            glClear(GL_COLOR_BUFFER_BIT);
+            scene.draw(-1, view);
+            glFinish();
+            r.ms.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - debut).count());
+            pic = max(pic, streamer.residentCount() + streamer.loadingCount());
+            pacer.wait();
+        }
+        r.extra["chunks"] = (double)streamer.chunkCount();
+        r.extra["resident_end"] = (double)streamer.residentCount();
+    }
+    r.extra["budget"] = (double)WORLD_MAX_RESIDENT;
+    r.extra["peak_resident"] = (double)pic;
+    r.extra["within_budget"] = pic <= WORLD_MAX_RESIDENT ? 1 : 0;
+    r.extra["loads_completed"] = (double)charges;
+    // Les chunks restent dans la scène une fois le streamer détruit : retirés à la main
+    while (scene.objectCount() > avant) scene.remove(scene.objectCount() - 1);
+    results.push_back(r);
+}
+
+// Le vrai RenderThread (chargement, scène, envois GL, échange de tampons) sur le contexte du bench,
+// pendant que ce thread enchaîne sauvegardes et relectures comme le ferait le découpage : intervalles
+// entre deux SDL_GL_SwapWindow. Le contexte doit être libre ; il l'est de nouveau au retour.
+static void benchRenderThread(vector<Result>& results, SDL_Window* window, SDL_GLContext context, Objx px) {
+    string path = string(TEMP_DIR) + "/pacing_render.objx";
+    px.setEmplacement(path);
+    vector<string> archives;
+    if (fs::exists(GROUND_ARCHIVE)) archives.push_back(GROUND_ARCHIVE);
+
+    vector<chrono::steady_clock::time_point> swaps;
+    size_t cycles = 0;
+    {
+        Silence silence; // avant le thread : rdbuf n'est pas changé pendant qu'il écrit
+        RenderThread renderer(window, context, FRAME_WIDTH, FRAME_HEIGHT, archives);
+        FrameState state;
+        renderer.publish(state);
+        renderer.recordFrames(true);
+        auto limite = chrono::steady_clock::now() + chrono::seconds(30); // contexte sans échange qui avance
+        while (swaps.size() <= (size_t)PACING_FRAMES && chrono::steady_clock::now() < limite) {
+            px.save();
+            Objx::open(path);
+            state.view.scale *= 1.01f;
+            renderer.publish(state);
+            renderer.takeFrameTimes(swaps);
+            ++cycles;
+        }
+        renderer.stop();
+    }
+    SDL_GL_MakeCurrent(window, context);
+    if (swaps.size() < 2) {
+        results.push_back({"frame_pacing/render_thread", {}, "aucune frame échangée", {}});
+        return;
+    }
+    vector<double> intervals;
+    for (size_t i = 1; i < swaps.size() && intervals.size() < (size_t)PACING_FRAMES; ++i) {
+        intervals.push_back(chrono::duration<double, milli>(swaps[i] - swaps[i - 1]).count());
+    }
+    Result r = pacingResult("frame_pacing/render_thread", intervals);
+    r.extra["io_cycles"] = (double)cycles;
+    results.push_back(r);
+}
+
+static void benchFrames(vector<Result>& results, int iterations, const string& world, const Objx& synthetique) {
+    const char* driver = getenv("SDL_VIDEODRIVER");
+    if (!driver) setenv("SDL_VIDEODRIVER", "offscreen", 0);
+    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
+        results.push_back({"frame/submit", {}, string("SDL_Init : ") + SDL_GetError(), {}});
+        results.push_back({"world/stream", {}, string("SDL_Init : ") + SDL_GetError(), {}});
+        results.push_back({"frame_pacing/render_thread", {}, string("SDL_Init : ") + SDL_GetError(), {}});
+        return;
+    }
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
+    SDL_Window* window = SDL_CreateWindow("Origamix bench", 0, 0, FRAME_WIDTH, FRAME_HEIGHT,
+                                          SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+    SDL_GLContext context = window ? SDL_GL_CreateContext(window) : nullptr;
+    if (!context) {
+        results.push_back({"frame/submit", {}, string("pas de contexte GL : ") + SDL_GetError(), {}});
+        results.push_back({"world/stream", {}, string("pas de contexte GL : ") + SDL_GetError(), {}});
+        results.push_back({"frame_pacing/render_thread", {}, string("pas de contexte GL : ") + SDL_GetError(), {}});
+        if (window) SDL_DestroyWindow(window);
+        SDL_Quit();
+        return;
+    }
+
+    GLuint program = benchProgram();
+    glUseProgram(program);
+    GLint scaleLoc = glGetUniformLocation(program, "scale");
+    glViewport(0, 0, FRAME_WIDTH, FRAME_HEIGHT);
+    {
+        ThreadPool pool;
+        TextureStreamer textures(pool);
+        GpuMeshCache meshes;
+        meshes.setAttributes(glGetAttribLocation(program, "vPosition"), glGetAttribLocation(program, "aTexCoord"));
+        Scene scene(textures, meshes);
+        vector<Objx> objxs;
+        {
+            Silence s;
+            if (fs::exists(GROUND_ARCHIVE)) objxs.push_back(Objx::open(GROUND_ARCHIVE));
+            objxs.push_back(syntheticObjx());
+            scene.load(std::move(objxs));
+            while (textures.pending()) textures.update(SIZE_MAX); // textures complètes avant de mesurer
+        }
+
+        ViewParams view; // toute la scène dans le champ : on mesure la soumission, pas le culling
+        view.scale = 0.05f;
+        glUniform1f(scaleLoc, view.scale);
+        Result r = measure("frame/submit", iterations, [&]() {
+            glClear(GL_COLOR_BUFFER_BIT);
+            scene.draw(-1, view);
+            glFinish(); // le travail en file ne doit pas déborder sur l'itération suivante
+        });
+        r.extra["objects"] = (double)scene.objectCount();
+        r.extra["visible_objects"] = (double)scene.visibleObjectCount();
+        results.push_back(r);
+
+        benchWorldStream(results, world, pool, textures, scene);
+
+        scene.clear();
+        meshes.clear();
+        textures.clear();
+    }
+    glDeleteProgram(program);
+
+    SDL_GL_MakeCurrent(window, nullptr);
+    benchRenderThread(results, window, context, synthetique);
+    SDL_GL_DeleteContext(context);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+}
+
+static string jsonString(const string& s) {
+    ostringstream out;
+    out << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') out << '\\' << c;
+        else if ((unsigned char)c < 0x20) out << ' ';
+        else out << c;
+    }
+    out << '"';
+    return out.str();
+}
+
+static string toJson(const vector<Result>& results, const string& commit) {
+    ostringstream out;
+    out << "{\n  \"commit\": " << jsonString(commit) << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"name\": " << jsonString(r.name);
+        if (!r.skipped.empty()) {
+            out << ", \"skipped\": " << jsonString(r.skipped);
+        } else {
+            vector<double> tri = r.ms;
+            sort(tri.begin(), tri.end());
+            double total = 0;
+            for (double d : tri) total += d;
+            out << ", \"iterations\": " << tri.size() << ", \"mean_ms\": " << total / tri.size()
+                << ", \"median_ms\": " << tri[tri.size() / 2] << ", \"min_ms\": " << tri.front()
+                << ", \"max_ms\": " << tri.back();
+        }
+        for (const auto& [key, value] : r.extra) out << ", " << jsonString(key) << ": " << value;
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return out.str();
+}
+
+int main(int argc, char** argv) {
+    string outPath, commit;
+    int iterations = 10;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--out") && i + 1 < argc) outPath = argv[++i];
+        else if (!strcmp(argv[i], "--commit") && i + 1 < argc) commit = argv[++i];
+        else if (!strcmp(argv[i], "--iterations") && i + 1 < argc) iterations = max(1, atoi(argv[++i]));
+    }
+
+    IMG_Init(IMG_INIT_PNG);
+    fs::create_directories(TEMP_DIR);
+    vector<Result> results;
+
+    // Archive fournie
+    benchArchive(results, "ground", GROUND_ARCHIVE, iterations);
+
+    // Objet synthétique : sauvegarde dans les deux formats, puis relecture
+    Objx synthetique = syntheticObjx();
+    SaveOptions options;
+    options.mesh = MeshFormat::Text;
+    benchSave(results, synthetique, "synthetic", options, iterations);
+    options.mesh = MeshFormat::Binary;
+    benchSave(results, synthetique, "synthetic", options, iterations);
+    benchArchive(results, "synthetic", string(TEMP_DIR) + "/synthetic.objx", iterations);
+    benchStartup(results, iterations);
+
+    // meshb aux sommets 16 bits
+    options.quantize = true;
+    benchSave(results, synthetique, "synthetic_quantized", options, iterations);
+    benchArchive(results, "synthetic_quantized", string(TEMP_DIR) + "/synthetic_quantized.objx", iterations);
+    options.quantize = false;
+
+    // Profil aligné : relu par mmap, textures pré-décodées
+    options.aligned = true;
+    benchSave(results, synthetique, "synthetic_aligned", options, iterations);
+    benchArchive(results, "synthetic_aligned", string(TEMP_DIR) + "/synthetic_aligned.objx", iterations);
+
+    Result maison = measure("texture_decode/maison.png", iterations, [&]() {
+        ImageRGBA img;
+        decodeImageFile(MAISON_PNG, img);
+    });
+    results.push_back(maison);
+
+    benchPicking(results, iterations);
+    benchOutline(results, iterations);
+    benchLod(results, iterations);
+    benchMeshText(results, iterations);
+    benchQuantize(results, iterations, synthetique);
+    benchFramePacing(results, synthetique);
+    string world = buildBenchWorld(results, synthetique);
+    benchFrames(results, iterations * 10, world, synthetique);
+
+    fs::remove_all(TEMP_DIR);
+    IMG_Quit();
+
+    string json = toJson(results, commit);
+    if (outPath.empty()) {
+        cout << json;
+    } else {
+        ofstream(outPath) << json;
+        cout << "[bench] " << results.size() << " mesures écrites dans " << outPath << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,410 @@
+// archive.cpp
+#include "archive.hpp"
+#include <zip.h>
+#include <zlib.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Signatures et champs zip (APPNOTE 4.3), petit-boutiste
+static const uint32_t ZIP_LOCAL_SIG = 0x04034b50;
+static const uint32_t ZIP_CENTRAL_SIG = 0x02014b50;
+static const uint32_t ZIP_END_SIG = 0x06054b50;
+static const size_t ZIP_LOCAL_SIZE = 30, ZIP_CENTRAL_SIZE = 46, ZIP_END_SIZE = 22;
+static const uint16_t ZIP_ALIGN_EXTRA_ID = 0xD935; // même identifiant que zipalign
+static const uint16_t ZIP_DOS_DATE = (0 << 9) | (1 << 5) | 1; // 1980-01-01 : archives reproductibles
+
+static uint16_t get16(const unsigned char* p) { return (uint16_t)(p[0] | p[1] << 8); }
+static uint32_t get32(const unsigned char* p) { return (uint32_t)get16(p) | (uint32_t)get16(p + 2) << 16; }
+static void put16(vector<unsigned char>& out, uint16_t v) { out.insert(out.end(), {(unsigned char)v, (unsigned char)(v >> 8)}); }
+static void put32(vector<unsigned char>& out, uint32_t v) { put16(out, (uint16_t)v); put16(out, (uint16_t)(v >> 16)); }
+
+// Fichier projeté en lecture seule, libéré avec le dernier Blob qui y pointe
+struct Mapping {
+    void* addr = MAP_FAILED;
+    size_t size = 0;
+    ~Mapping() {
+        if (addr != MAP_FAILED) munmap(addr, size);
+    }
+};
+
+Blob Blob::slice(size_t offset, size_t length) const {
+    Blob b;
+    if (offset > size) return b;
+    b.data = data + offset;
+    b.size = min(length, size - offset);
+    b.owner = owner;
+    return b;
+}
+
+Blob Blob::fromVector(vector<unsigned char>&& bytes) {
+    auto owned = make_shared<vector<unsigned char>>(std::move(bytes));
+    Blob b;
+    b.data = owned->data();
+    b.size = owned->size();
+    b.owner = owned;
+    return b;
+}
+
+Blob Blob::fromFile(const string& path) {
+    ifstream in(path, ios::binary | ios::ate);
+    if (!in.is_open()) return Blob();
+    vector<unsigned char> bytes((size_t)in.tellg());
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+    if (!in) return Blob();
+    return fromVector(std::move(bytes));
+}
+
+uint64_t hashBytes(const unsigned char* data, size_t size) {
+    const uint64_t K = 0x9E3779B97F4A7C15ull;
+    uint64_t h = size * K;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t w;
+        memcpy(&w, data + i, 8);
+        h = (h ^ (w * K)) * 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 31;
+    }
+    uint64_t reste = 0;
+    if (size > i) memcpy(&reste, data + i, size - i);
+    h = (h ^ (reste * K)) * 0x94D049BB133111EBull;
+    return h ^ (h >> 29);
+}
+
+// Archive entière en mémoire (projetée ou copiée) dont toutes les entrées sont stockées : les Blob
+// pointent dans file et partagent son owner. false si une entrée est compressée ou le zip inattendu.
+static bool readStoredEntries(const Blob& file, map<string, Blob>& entries) {
+    const unsigned char* base = file.data;
+    size_t size = file.size;
+    if (size < ZIP_END_SIZE) return false;
+
+    // Fin du répertoire central : dans les 22 + 65535 derniers octets (commentaire de longueur variable)
+    size_t end = size - ZIP_END_SIZE;
+    size_t limite = size > ZIP_END_SIZE + 0xFFFF ? size - ZIP_END_SIZE - 0xFFFF : 0;
+    while (get32(base + end) != ZIP_END_SIG) {
+        if (end == limite) return false;
+        --end;
+    }
+    size_t count = get16(base + end + 10);
+    size_t cdSize = get32(base + end + 12), cdOffset = get32(base + end + 16);
+    if (count == 0xFFFF || cdOffset == 0xFFFFFFFF || cdOffset + cdSize > end) return false; // zip64 : libzip
+
+    map<string, Blob> lues;
+    size_t pos = cdOffset;
+    for (size_t i = 0; i < count; ++i) {
+        if (pos + ZIP_CENTRAL_SIZE > end || get32(base + pos) != ZIP_CENTRAL_SIG) return false;
+        const unsigned char* h = base + pos;
+        uint16_t flags = get16(h + 8), method = get16(h + 10);
+        uint32_t compSize = get32(h + 20), rawSize = get32(h + 24);
+        size_t nameLen = get16(h + 28), extraLen = get16(h + 30), commentLen = get16(h + 32);
+        size_t local = get32(h + 42);
+        if (method != 0 || (flags & 1) || compSize != rawSize) return false; // compressée ou chiffrée
+        if (pos + ZIP_CENTRAL_SIZE + nameLen > end) return false;
+        string name(reinterpret_cast<const char*>(h + ZIP_CENTRAL_SIZE), nameLen);
+        pos += ZIP_CENTRAL_SIZE + nameLen + extraLen + commentLen;
+
+        if (local + ZIP_LOCAL_SIZE > size || get32(base + local) != ZIP_LOCAL_SIG) return false;
+        size_t data = local + ZIP_LOCAL_SIZE + get16(base + local + 26) + get16(base + local + 28);
+        if (data + rawSize > size) return false;
+
+        lues[name] = file.slice(data, rawSize);
+    }
+    for (auto& [name, b] : lues) entries[name] = std::move(b);
+    return true;
+}
+
+bool readArchiveMapped(const string& path, map<string, Blob>& entries) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    auto mapping = make_shared<Mapping>();
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= ZIP_END_SIZE) {
+        mapping->size = (size_t)st.st_size;
+        mapping->addr = mmap(nullptr, mapping->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (mapping->addr == MAP_FAILED) return false;
+
+    Blob file;
+    file.data = static_cast<const unsigned char*>(mapping->addr);
+    file.size = mapping->size;
+    file.owner = mapping;
+    return readStoredEntries(file, entries);
+}
+
+bool readArchive(const string& path, map<string, Blob>& entries, ArchiveAccess access) {
+    zip_t* archive = nullptr;
+    Blob file; // Copied : garde la copie en vie jusqu'à zip_close
+    if (access == ArchiveAccess::Mapped) {
+        if (readArchiveMapped(path, entries)) return true;
+        int err = 0;
+        archive = zip_open(path.c_str(), ZIP_RDONLY, &err);
+        if (!archive) {
+            cerr << "Erreur ouverture archive: code=" << err << endl;
+            return false;
+        }
+    } else {
+        // Une seule lecture du fichier : profil aligné découpé dans la copie, sinon libzip sur la copie
+        file = Blob::fromFile(path);
+        if (readStoredEntries(file, entries)) return true;
+        zip_source_t* source = file.empty() ? nullptr : zip_source_buffer_create(file.data, file.size, 0, nullptr);
+        archive = source ? zip_open_from_source(source, ZIP_RDONLY, nullptr) : nullptr;
+        if (!archive) {
+            if (source) zip_source_free(source);
+            cerr << "Erreur ouverture archive: " << path << endl;
+            return false;
+        }
+    }
+
+    zip_int64_t num_files = zip_get_num_entries(archive, 0);
+    for (zip_int64_t i = 0; i < num_files; ++i) {
+        zip_stat_t st;
+        zip_stat_init(&st);
+        if (zip_stat_index(archive, i, 0, &st) != 0 || !(st.valid & ZIP_STAT_NAME)) continue;
+
+        zip_file_t* zf = zip_fopen_index(archive, i, 0);
+        if (!zf) continue;
+
+        // Taille connue d'avance : une seule allocation, lue d'un bloc.
+        // Les entrées stockées (ZIP_CM_STORE) sont copiées telles quelles, sans passer par inflate.
+        vector<unsigned char> bytes((st.valid & ZIP_STAT_SIZE) ? st.size : 0);
+        size_t total = 0;
+        bool ok = true;
+        while (total < bytes.size()) {
+            zip_int64_t n = zip_fread(zf, bytes.data() + total, bytes.size() - total);
+            if (n <= 0) { ok = false; break; }
+            total += n;
+        }
+        zip_fclose(zf);
+
+        if (!ok) {
+            cerr << "Erreur lecture de " << st.name << " dans " << path << endl;
+            continue;
+        }
+        entries[st.name] = Blob::fromVector(std::move(bytes));
+    }
+
+    zip_close(archive);
+    return true;
+}
+
+bool writeArchive(const string& path, const vector<ArchiveEntry>& entries, ArchiveWriteStats* stats) {
+    ArchiveWriteStats local;
+    ArchiveWriteStats& st = stats ? *stats : local;
+    st = ArchiveWriteStats();
+
+    int err = 0;
+    zip_t* archive = zip_open(path.c_str(), ZIP_CREATE, &err);
+    if (!archive) {
+        cerr << "Erreur ouverture archive en écriture: code=" << err << endl;
+        return false;
+    }
+
+    map<string, zip_stat_t> existantes;
+    zip_int64_t num_files = zip_get_num_entries(archive, 0);
+    for (zip_int64_t i = 0; i < num_files; ++i) {
+        zip_stat_t s;
+        zip_stat_init(&s);
+        if (zip_stat_index(archive, i, 0, &s) == 0 && (s.valid & ZIP_STAT_NAME)) existantes[s.name] = s;
+    }
+
+    set<string> gardees;
+    for (const auto& e : entries) {
+        gardees.insert(e.name);
+        auto it = existantes.find(e.name);
+        if (it != existantes.end() && (it->second.valid & ZIP_STAT_SIZE) && (it->second.valid & ZIP_STAT_CRC)
+            && it->second.size == e.data.size
+            && it->second.crc == crc32(0L, e.data.data, (uInt)e.data.size)) {
+            st.unchanged++;
+            continue;
+        }
+
+        // Le Blob reste vivant dans entries jusqu'à zip_close, qui lit la source à ce moment-là
+        zip_source_t* source = zip_source_buffer(archive, e.data.data, e.data.size, 0);
+        zip_int64_t index = source ? zip_file_add(archive, e.name.c_str(), source, ZIP_FL_OVERWRITE) : -1;
+        if (index < 0) {
+            if (source) zip_source_free(source);
+            cerr << "Erreur ajout de " << e.name << " : " << zip_strerror(archive) << endl;
+            zip_discard(archive);
+            return false;
+        }
+        zip_set_file_compression(archive, index, e.compress ? ZIP_CM_DEFLATE : ZIP_CM_STORE, 0);
+        st.written++;
+        st.bytesWritten += e.data.size;
+    }
+
+    for (const auto& [name, s] : existantes) {
+        if (gardees.count(name)) continue;
+        zip_delete(archive, s.index);
+        st.removed++;
+    }
+
+    if (zip_close(archive) != 0) {
+        cerr << "Erreur écriture archive " << path << " : " << zip_strerror(archive) << endl;
+        zip_discard(archive);
+        return false;
+    }
+    return true;
+}
+
+// Noms des entrées d'une archive existante, compressée ou non ; vide si elle n'existe pas
+static set<string> entryNames(const string& path) {
+    set<string> noms;
+    int err = 0;
+    zip_t* archive = zip_open(path.c_str(), ZIP_RDONLY, &err);
+    if (!archive) return noms;
+    zip_int64_t num_files = zip_get_num_entries(archive, 0);
+    for (zip_int64_t i = 0; i < num_files; ++i) {
+        const char* name = zip_get_name(archive, i, 0);
+        if (name) noms.insert(name);
+    }
+    zip_discard(archive);
+    return noms;
+}
+
+bool writeAlignedArchive(const string& path, const vector<ArchiveEntry>& entries, ArchiveWriteStats* stats) {
+    ArchiveWriteStats local;
+    ArchiveWriteStats& st = stats ? *stats : local;
+    st = ArchiveWriteStats();
+    if (entries.size() >= 0xFFFF) {
+        cerr << "Archive alignée : trop d'entrées (zip64 non géré) : " << path << endl;
+        return false;
+    }
+
+    vector<uint32_t> crcs;
+    for (const auto& e : entries) crcs.push_back(crc32(0L, e.data.data, (uInt)e.data.size));
+
+    // Archive déjà identique (mêmes entrées, mêmes octets, mêmes alignements) : rien à faire
+    map<string, Blob> existantes;
+    bool projetee = readArchiveMapped(path, existantes);
+    if (projetee && existantes.size() == entries.size()) {
+        bool identique = true;
+        for (size_t i = 0; i < entries.size() && identique; ++i) {
+            auto it = existantes.find(entries[i].name);
+            const Blob& e = entries[i].data;
+            identique = it != existantes.end() && it->second.size == e.size
+                     && (entries[i].align <= 1 || (uintptr_t)it->second.data % entries[i].align == 0) // mmap aligné sur la page
+                     && crc32(0L, it->second.data, (uInt)it->second.size) == crcs[i];
+        }
+        if (identique) {
+            st.unchanged = entries.size();
+            return true;
+        }
+    }
+
+    // Entrées de l'ancienne archive absentes de la nouvelle, comme writeArchive les compte
+    set<string> anciennes;
+    if (projetee) {
+        for (const auto& [name, blob] : existantes) anciennes.insert(name);
+    } else {
+        anciennes = entryNames(path); // compressée : passage au profil aligné
+    }
+    for (const auto& e : entries) anciennes.erase(e.name);
+
+    vector<unsigned char> central;
+    string temp = path + ".tmp";
+    ofstream out(temp, ios::binary | ios::trunc);
+    if (!out) {
+        cerr << "Erreur écriture archive " << temp << endl;
+        return false;
+    }
+
+    size_t offset = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const ArchiveEntry& e = entries[i];
+        size_t extra = 0;
+        if (e.align > 1) {
+            size_t debut = offset + ZIP_LOCAL_SIZE + e.name.size();
+            extra = (e.align - debut % e.align) % e.align;
+            if (extra && extra < 4) extra += e.align; // le champ extra a un en-tête de 4 octets
+        }
+        if (offset + ZIP_LOCAL_SIZE + e.name.size() + extra + e.data.size > 0xFFFFFFFFu || e.name.size() > 0xFFFF) {
+            cerr << "Archive alignée trop grande (zip64 non géré) : " << path << endl;
+            out.close();
+            fs::remove(temp);
+            return false;
+        }
+
+        vector<unsigned char> h;
+        put32(h, ZIP_LOCAL_SIG);
+        put16(h, 10);     // version nécessaire : 1.0 (stockée)
+        put16(h, 0x0800); // noms en UTF-8
+        put16(h, 0);      // méthode : stockée
+        put16(h, 0);
+        put16(h, ZIP_DOS_DATE);
+        put32(h, crcs[i]);
+        put32(h, (uint32_t)e.data.size);
+        put32(h, (uint32_t)e.data.size);
+        put16(h, (uint16_t)e.name.size());
+        put16(h, (uint16_t)extra);
+        h.insert(h.end(), e.name.begin(), e.name.end());
+        if (extra) {
+            put16(h, ZIP_ALIGN_EXTRA_ID);
+            put16(h, (uint16_t)(extra - 4));
+            h.resize(h.size() + extra - 4, 0);
+        }
+        out.write(reinterpret_cast<const char*>(h.data()), h.size());
+        out.write(reinterpret_cast<const char*>(e.data.data), e.data.size);
+
+        put32(central, ZIP_CENTRAL_SIG);
+        put16(central, 20); // créée par : 2.0
+        put16(central, 10);
+        put16(central, 0x0800);
+        put16(central, 0);
+        put16(central, 0);
+        put16(central, ZIP_DOS_DATE);
+        put32(central, crcs[i]);
+        put32(central, (uint32_t)e.data.size);
+        put32(central, (uint32_t)e.data.size);
+        put16(central, (uint16_t)e.name.size());
+        put16(central, 0); // extra
+        put16(central, 0); // commentaire
+        put16(central, 0); // disque
+        put16(central, 0); // attributs internes
+        put32(central, 0); // attributs externes
+        put32(central, (uint32_t)offset);
+        central.insert(central.end(), e.name.begin(), e.name.end());
+
+        offset += h.size() + e.data.size;
+        st.written++;
+        st.bytesWritten += e.data.size;
+    }
+
+    vector<unsigned char> fin;
+    put32(fin, ZIP_END_SIG);
+    put16(fin, 0);
+    put16(fin, 0);
+    put16(fin, (uint16_t)entries.size());
+    put16(fin, (uint16_t)entries.size());
+    put32(fin, (uint32_t)central.size());
+    put32(fin, (uint32_t)offset);
+    put16(fin, 0);
+    out.write(reinterpret_cast<const char*>(central.data()), central.size());
+    out.write(reinterpret_cast<const char*>(fin.data()), fin.size());
+    out.close();
+    if (!out || offset + central.size() > 0xFFFFFFFFu) {
+        cerr << "Erreur écriture archive " << temp << endl;
+        fs::remove(temp);
+        return false;
+    }
+
+    error_code ec;
+    fs::rename(temp, path, ec); // atomique sur le même système de fichiers
+    if (ec) {
+        cerr << "Erreur renommage " << temp << " : " << ec.message() << endl;
+        fs::remove(temp);
+        return false;
+    }
+    st.removed = anciennes.size();
+    return true;
+}
@@ -0,0 +1,60 @@
+// archive.hpp
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <cstdint>
+
+// Octets en lecture seule, partagés : copier un Blob ne copie pas les données
+struct Blob {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    std::shared_ptr<const void> owner; // garde en vie la mémoire pointée
+
+    bool empty() const { return size == 0; }
+    Blob slice(size_t offset, size_t length) const; // vue partageant owner, bornée à size
+    static Blob fromVector(std::vector<unsigned char>&& bytes);
+    static Blob fromFile(const std::string& path);
+};
+
+// Empreinte rapide, non cryptographique (8 octets par tour) : identifie un contenu sans le décoder
+uint64_t hashBytes(const unsigned char* data, size_t size);
+
+// Mapped : une archive dont toutes les entrées sont stockées (profil aligné) est projetée par mmap, les
+// Blob pointent dans le fichier projeté et les pages sont lues au premier accès.
+// Copied : le fichier est lu d'un bloc et les Blob pointent dans cette copie. Pour les dossiers surveillés
+// (HotReload) : un éditeur qui réécrit l'archive sur place changerait les octets sous des Blob encore
+// vivants (MAP_PRIVATE ne fige que les pages déjà lues), ou SIGBUS si le fichier raccourcit.
+enum class ArchiveAccess { Mapped, Copied };
+
+// Lit toutes les entrées d'une archive .plxl/.objx directement en mémoire (rien n'est écrit sur le disque).
+// Profil aligné découpé sans décompression selon access ; sinon, lecture par libzip.
+bool readArchive(const std::string& path, std::map<std::string, Blob>& entries,
+                 ArchiveAccess access = ArchiveAccess::Mapped);
+bool readArchiveMapped(const std::string& path, std::map<std::string, Blob>& entries); // false si une entrée est compressée
+
+// Entrée à écrire, prise en mémoire
+struct ArchiveEntry {
+    std::string name;
+    Blob data;
+    bool compress = true; // false : stockée telle quelle (PNG, ETC1, déjà compressés)
+    size_t align = 0;     // writeAlignedArchive : alignement des données dans le fichier (0 = aucun)
+};
+
+struct ArchiveWriteStats {
+    size_t written = 0, unchanged = 0, removed = 0;
+    size_t bytesWritten = 0; // octets non compressés des entrées réécrites
+};
+
+// Met l'archive en accord avec entries : seules les entrées dont la taille ou le CRC-32 diffère sont
+// réécrites, les autres sont recopiées brutes par libzip, celles qui ne sont plus listées sont supprimées.
+// libzip écrit dans un fichier temporaire renommé sur l'original à la fermeture : une sauvegarde
+// interrompue laisse l'ancienne archive intacte. Sans aucun changement, le fichier n'est pas touché.
+bool writeArchive(const std::string& path, const std::vector<ArchiveEntry>& entries, ArchiveWriteStats* stats = nullptr);
+
+// Profil aligné, dans l'esprit de zipalign : toutes les entrées stockées sans compression, les données
+// de chacune commencent à un multiple de son align (bourrage dans le champ extra 0xD935 de l'en-tête local).
+// L'archive reste un zip ordinaire. Écrite dans path + ".tmp" puis renommée ; rien n'est écrit si
+// l'archive existante a déjà exactement ce contenu.
+bool writeAlignedArchive(const std::string& path, const std::vector<ArchiveEntry>& entries, ArchiveWriteStats* stats = nullptr);
@@ -0,0 +1,17 @@
+// asset_loader.cpp
+#include "asset_loader.hpp"
+#include <future>
+
+using namespace std;
+
+vector<Objx> loadAssets(const vector<string>& paths, ThreadPool& pool) {
+    vector<future<Objx>> opened;
+    for (const auto& path : paths) {
+        opened.push_back(pool.submit([path]() { return Objx::open(path, ArchiveAccess::Copied); }));
+    }
+
+    vector<Objx> objxs;
+    objxs.reserve(paths.size());
+    for (auto& f : opened) objxs.push_back(f.get());
+    return objxs;
+}
@@ -0,0 +1,12 @@
+// asset_loader.hpp
+#pragma once
+#include "objx.hpp"
+#include "thread_pool.hpp"
+#include <string>
+#include <vector>
+
+// Décompression et parsing des archives répartis sur le pool, une tâche par archive.
+// Les textures ne sont pas décodées ici : TextureStreamer s'en charge sur le même pool.
+// Archives lues par copie (ArchiveAccess::Copied) : le dossier est surveillé par HotReload.
+// Les résultats sont dans l'ordre de paths.
+std::vector<Objx> loadAssets(const std::vector<std::string>& paths, ThreadPool& pool);
@@ -0,0 +1,48 @@
+// asset_watcher.cpp
+#include "asset_watcher.hpp"
+#include <filesystem>
+#include <iostream>
+#include <map>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+namespace fs = std::filesystem;
+
+AssetWatcher::AssetWatcher(const string& directory) : directory(directory) {
+#ifdef __linux__
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd >= 0) {
+        wd = inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_ONLYDIR);
+    }
+    if (wd < 0) cerr << "[hot-reload] impossible de surveiller " << directory << endl;
+#endif
+}
+
+AssetWatcher::~AssetWatcher() {
+#ifdef __linux__
+    if (fd >= 0) close(fd);
+#endif
+}
+
+void AssetWatcher::poll(vector<Change>& out) {
+    out.clear();
+#ifdef __linux__
+    if (wd < 0) return;
+    map<string, Kind> derniers; // un éditeur peut écrire plusieurs fois de suite le même fichier
+    alignas(inotify_event) char buf[4096];
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof buf)) > 0) {
+        for (char* p = buf; p < buf + n;) {
+            auto* ev = reinterpret_cast<inotify_event*>(p);
+            p += sizeof(inotify_event) + ev->len;
+            if (ev->len == 0 || (ev->mask & IN_ISDIR)) continue;
+            string path = (fs::path(directory) / ev->name).string();
+            derniers[path] = (ev->mask & (IN_DELETE | IN_MOVED_FROM)) ? Kind::Removed : Kind::Changed;
+        }
+    }
+    for (auto& [path, kind] : derniers) out.push_back({kind, path});
+#endif
+}
@@ -0,0 +1,31 @@
+// asset_watcher.hpp
+#pragma once
+#include <string>
+#include <vector>
+
+// Surveille un dossier d'assets (inotify, Linux) : fichiers créés, modifiés, supprimés ou renommés.
+// Un fichier n'est signalé qu'une fois fermé après écriture ou renommé dans le dossier (sauvegarde
+// atomique de writeArchive), jamais à moitié écrit. Un éditeur qui réécrit un fichier sur place est signalé
+// à la fermeture ; les archives du dossier sont lues par copie (ArchiveAccess::Copied), donc les objets
+// déjà chargés ne voient jamais l'écriture en cours. Ailleurs que sous Linux, poll() ne signale rien.
+class AssetWatcher {
+public:
+    enum class Kind { Changed, Removed }; // Changed : créé ou modifié
+    struct Change {
+        Kind kind;
+        std::string path; // directory/nom, comme directory_iterator
+    };
+
+    explicit AssetWatcher(const std::string& directory);
+    ~AssetWatcher();
+    AssetWatcher(const AssetWatcher&) = delete;
+    AssetWatcher& operator=(const AssetWatcher&) = delete;
+
+    bool active() const { return wd >= 0; }
+    // Changements depuis le dernier appel, sans bloquer ; un seul par fichier, le dernier l'emporte
+    void poll(std::vector<Change>& out);
+
+private:
+    std::string directory;
+    int fd = -1, wd = -1;
+};
@@ -0,0 +1,97 @@
+// atlas.cpp
+#include "atlas.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+using namespace std;
+
+bool pngSize(const Blob& png, int& w, int& h) {
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (png.size < 24 || memcmp(png.data, signature, 8) != 0 || memcmp(png.data + 12, "IHDR", 4) != 0) return false;
+    auto be32 = [](const unsigned char* p) { return (int)((uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3]); };
+    w = be32(png.data + 16);
+    h = be32(png.data + 20);
+    return w > 0 && h > 0;
+}
+
+SkylinePacker::SkylinePacker(int width, int height) : width(width), height(height) {
+    skyline.push_back({0, 0, width});
+}
+
+bool SkylinePacker::insert(int w, int h, int& outX, int& outY) {
+    int bestY = INT_MAX, bestX = 0, bestWaste = INT_MAX;
+    size_t bestIndex = SIZE_MAX;
+
+    for (size_t i = 0; i < skyline.size(); ++i) {
+        int x = skyline[i].x;
+        if (x + w > width) break;
+        // Hauteur de pose = max des segments couverts par [x, x + w)
+        int y = 0, waste = 0;
+        for (size_t j = i; j < skyline.size() && skyline[j].x < x + w; ++j) y = max(y, skyline[j].y);
+        if (y + h > height) continue;
+        for (size_t j = i; j < skyline.size() && skyline[j].x < x + w; ++j) {
+            int covered = min(x + w, skyline[j].x + skyline[j].w) - skyline[j].x;
+            waste += (y - skyline[j].y) * covered;
+        }
+        if (y < bestY || (y == bestY && waste < bestWaste)) {
+            bestY = y;
+            bestX = x;
+            bestWaste = waste;
+            bestIndex = i;
+        }
+    }
+    if (bestIndex == SIZE_MAX) return false;
+
+    // Nouveau segment, puis rognage de ceux qu'il recouvre
+    Segment placed{bestX, bestY + h, w};
+    skyline.insert(skyline.begin() + bestIndex, placed);
+    size_t i = bestIndex + 1;
+    while (i < skyline.size() && skyline[i].x < placed.x + placed.w) {
+        int end = skyline[i].x + skyline[i].w;
+        if (end <= placed.x + placed.w) {
+            skyline.erase(skyline.begin() + i);
+        } else {
+            skyline[i].w = end - (placed.x + placed.w);
+            skyline[i].x = placed.x + placed.w;
+            break;
+        }
+    }
+    // Fusion des voisins de même hauteur
+    for (size_t j = 0; j + 1 < skyline.size();) {
+        if (skyline[j].y == skyline[j + 1].y) {
+            skyline[j].w += skyline[j + 1].w;
+            skyline.erase(skyline.begin() + j + 1);
+        } else {
+            ++j;
+        }
+    }
+
+    outX = bestX;
+    outY = bestY;
+    return true;
+}
+
+bool composeAtlasPage(const vector<AtlasSource>& sources, int pageW, int pageH, ImageRGBA& page) {
+    page.w = pageW;
+    page.h = pageH;
+    page.pixels.assign((size_t)pageW * pageH * 4, 0);
+
+    for (const auto& src : sources) {
+        ImageRGBA img;
+        if (!decodeImage(src.png, img)) continue;
+        // Copie avec marge : les coordonnées hors image sont ramenées sur le bord le plus proche
+        for (int y = -ATLAS_GUTTER; y < img.h + ATLAS_GUTTER; ++y) {
+            int dy = src.y + y;
+            if (dy < 0 || dy >= pageH) continue;
+            int sy = min(max(y, 0), img.h - 1);
+            for (int x = -ATLAS_GUTTER; x < img.w + ATLAS_GUTTER; ++x) {
+                int dx = src.x + x;
+                if (dx < 0 || dx >= pageW) continue;
+                int sx = min(max(x, 0), img.w - 1);
+                memcpy(&page.pixels[((size_t)dy * pageW + dx) * 4], &img.pixels[((size_t)sy * img.w + sx) * 4], 4);
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,32 @@
+// atlas.hpp
+#pragma once
+#include "archive.hpp"
+#include "texture.hpp"
+#include <vector>
+
+// Dimensions lues dans l'en-tête IHDR, sans décoder l'image
+bool pngSize(const Blob& png, int& w, int& h);
+
+// Rangement "skyline" (bas-gauche) de rectangles dans une page de taille fixe
+class SkylinePacker {
+public:
+    SkylinePacker(int width, int height);
+    bool insert(int w, int h, int& x, int& y); // false si la page est pleine
+
+private:
+    struct Segment { int x, y, w; };
+    std::vector<Segment> skyline;
+    int width, height;
+};
+
+// Une texture à copier dans une page d'atlas ; (x, y) = coin de la zone utile, hors marge
+struct AtlasSource {
+    Blob png;
+    int x = 0, y = 0;
+};
+
+// Marge autour de chaque texture, remplie en répétant les bords (limite le débordement des mipmaps)
+constexpr int ATLAS_GUTTER = 4;
+
+// Décode les sources et les copie dans une page transparente (appelé depuis le pool)
+bool composeAtlasPage(const std::vector<AtlasSource>& sources, int pageW, int pageH, ImageRGBA& page);
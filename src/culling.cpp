@@ -0,0 +1,133 @@
+// culling.cpp
+#include "culling.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+static const size_t BVH_LEAF_SIZE = 4;
+
+void projectPoint(const ViewParams& view, float x, float y, float z, float clip[4]) {
+    float cosX = cos(view.angleX), sinX = sin(view.angleX);
+    float cosY = cos(view.angleY), sinY = sin(view.angleY);
+    float ry = y * cosX - z * sinX;
+    float rz = y * sinX + z * cosX;
+    float rx = x * cosY + rz * sinY;
+    rz = -x * sinY + rz * cosY;
+    clip[0] = rx * view.scale + view.offsetX;
+    clip[1] = ry * view.scale + view.offsetY;
+    clip[2] = rz * view.scale;
+    clip[3] = rz + 2.0f;
+}
+
+Visibility classify(const Aabb& box, const ViewParams& view) {
+    if (box.empty()) return Visibility::Outside;
+
+    // Plans : e*w - x >= 0, e*w + x >= 0, idem en y, w - z >= 0, w + z >= 0
+    unsigned outsideAll = 0x3F, outsideAny = 0;
+    for (int c = 0; c < 8; ++c) {
+        float p[4];
+        projectPoint(view, (c & 1) ? box.max[0] : box.min[0], (c & 2) ? box.max[1] : box.min[1],
+                     (c & 4) ? box.max[2] : box.min[2], p);
+        float ew = view.ndcExtent * p[3];
+        unsigned out = 0;
+        if (p[0] > ew) out |= 1;
+        if (p[0] < -ew) out |= 2;
+        if (p[1] > ew) out |= 4;
+        if (p[1] < -ew) out |= 8;
+        if (p[2] > p[3]) out |= 16;
+        if (p[2] < -p[3]) out |= 32;
+        outsideAll &= out;
+        outsideAny |= out;
+    }
+    if (outsideAll) return Visibility::Outside;
+    return outsideAny ? Visibility::Partial : Visibility::Inside;
+}
+
+float screenFraction(const Aabb& box, const ViewParams& view) {
+    if (box.empty()) return 0.0f;
+    float minX = INFINITY, maxX = -INFINITY, minY = INFINITY, maxY = -INFINITY;
+    for (int c = 0; c < 8; ++c) {
+        float p[4];
+        projectPoint(view, (c & 1) ? box.max[0] : box.min[0], (c & 2) ? box.max[1] : box.min[1],
+                     (c & 4) ? box.max[2] : box.min[2], p);
+        if (p[3] <= 0) return 1.0f;
+        float x = p[0] / p[3], y = p[1] / p[3];
+        minX = min(minX, x);
+        maxX = max(maxX, x);
+        minY = min(minY, y);
+        maxY = max(maxY, y);
+    }
+    return max(maxX - minX, maxY - minY) / (2 * view.ndcExtent);
+}
+
+void Bvh::build(const vector<Aabb>& source) {
+    nodes.clear();
+    items.clear();
+    boxes = source;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        if (!boxes[i].empty()) items.push_back(i);
+    }
+    if (!items.empty()) buildNode(0, items.size());
+}
+
+int Bvh::buildNode(size_t first, size_t count) {
+    int index = (int)nodes.size();
+    nodes.emplace_back();
+    Aabb box;
+    for (size_t i = first; i < first + count; ++i) box.extend(boxes[items[i]]);
+    nodes[index].box = box;
+
+    if (count <= BVH_LEAF_SIZE) {
+        nodes[index].first = first;
+        nodes[index].count = count;
+        return index;
+    }
+
+    int axis = 0;
+    for (int a = 1; a < 3; ++a) {
+        if (box.max[a] - box.min[a] > box.max[axis] - box.min[axis]) axis = a;
+    }
+    size_t mid = first + count / 2;
+    auto center = [&](size_t i) { return boxes[i].min[axis] + boxes[i].max[axis]; };
+    nth_element(items.begin() + first, items.begin() + mid, items.begin() + first + count,
+                [&](size_t a, size_t b) { return center(a) < center(b); });
+
+    int left = buildNode(first, mid - first);
+    int right = buildNode(mid, first + count - mid);
+    nodes[index].left = left;
+    nodes[index].right = right;
+    return index;
+}
+
+void Bvh::collect(int node, vector<size_t>& out) const {
+    const Node& n = nodes[node];
+    if (n.left < 0) {
+        out.insert(out.end(), items.begin() + n.first, items.begin() + n.first + n.count);
+        return;
+    }
+    collect(n.left, out);
+    collect(n.right, out);
+}
+
+void Bvh::visit(int node, const ViewParams& view, vector<size_t>& out) const {
+    const Node& n = nodes[node];
+    Visibility v = classify(n.box, view);
+    if (v == Visibility::Outside) return;
+    if (v == Visibility::Inside) {
+        collect(node, out);
+        return;
+    }
+    if (n.left < 0) {
+        for (size_t i = n.first; i < n.first + n.count; ++i) {
+            if (isVisible(boxes[items[i]], view)) out.push_back(items[i]);
+        }
+        return;
+    }
+    visit(n.left, view, out);
+    visit(n.right, view, out);
+}
+
+void Bvh::query(const ViewParams& view, vector<size_t>& out) const {
+    if (!nodes.empty()) visit(0, view, out);
+}
@@ -0,0 +1,49 @@
+// culling.hpp
+#pragma once
+#include "objx.hpp"
+#include <vector>
+
+// Uniformes de vue du viewer, tels qu'envoyés au vertex shader
+struct ViewParams {
+    float angleX = 0, angleY = 0;
+    float scale = 1.0f;
+    float offsetX = 0, offsetY = 0;
+    float ndcExtent = 1.0f; // partie de [-1,1] réellement couverte par la fenêtre (dépend de glViewport)
+};
+
+// Reproduit la transformation du vertex shader : (x, y, z, w) en coordonnées de découpage
+void projectPoint(const ViewParams& view, float x, float y, float z, float clip[4]);
+
+enum class Visibility { Outside, Partial, Inside };
+
+// Teste les 8 coins de la boîte contre les plans de la fenêtre (et near/far).
+// Outside si tous les coins sont du mauvais côté d'un même plan : la boîte est alors invisible.
+Visibility classify(const Aabb& box, const ViewParams& view);
+inline bool isVisible(const Aabb& box, const ViewParams& view) { return classify(box, view) != Visibility::Outside; }
+
+// Part de la fenêtre couverte par la boîte projetée : plus grand côté de son rectangle englobant,
+// 1 = toute la largeur (ou hauteur). Une boîte qui passe derrière l'œil (w <= 0) compte pour 1.
+float screenFraction(const Aabb& box, const ViewParams& view);
+
+// Hiérarchie de boîtes englobantes sur un ensemble d'objets (coupe médiane sur l'axe le plus long)
+class Bvh {
+public:
+    void build(const std::vector<Aabb>& boxes);
+    // Ajoute à out les indices des boîtes visibles ; les sous-arbres entièrement dedans ne sont plus testés
+    void query(const ViewParams& view, std::vector<size_t>& out) const;
+    bool empty() const { return nodes.empty(); }
+
+private:
+    struct Node {
+        Aabb box;
+        int left = -1, right = -1;   // enfants ; -1 = feuille
+        size_t first = 0, count = 0; // plage dans items pour une feuille
+    };
+    int buildNode(size_t first, size_t count);
+    void collect(int node, std::vector<size_t>& out) const;
+    void visit(int node, const ViewParams& view, std::vector<size_t>& out) const;
+
+    std::vector<Node> nodes;
+    std::vector<size_t> items;
+    std::vector<Aabb> boxes; // copie des boîtes, pour tester un à un les éléments d'une feuille partielle
+};
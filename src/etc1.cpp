@@ -0,0 +1,304 @@
+// etc1.cpp
+#include "etc1.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+
+const int MODIFIERS[8][4] = {
+    {2, 8, -2, -8}, {5, 17, -5, -17}, {9, 29, -9, -29}, {13, 42, -13, -42},
+    {18, 60, -18, -60}, {24, 80, -24, -80}, {33, 106, -33, -106}, {47, 183, -47, -183},
+};
+
+inline int clamp255(int v) { return v < 0 ? 0 : (v > 255 ? 255 : v); }
+inline int expand4(int c) { return (c << 4) | c; }
+inline int expand5(int c) { return (c << 3) | (c >> 2); }
+
+// Pixels d'un bloc 4x4, indexés comme ETC1 : p = x * 4 + y
+struct Block {
+    int rgb[16][3];
+};
+
+// Sous-bloc : 8 pixels, selon flip (0 = deux colonnes 2x4, 1 = deux lignes 4x2)
+void subblockPixels(int flip, int sub, int out[8]) {
+    int n = 0;
+    for (int x = 0; x < 4; ++x)
+        for (int y = 0; y < 4; ++y) {
+            int s = flip ? (y >= 2) : (x >= 2);
+            if (s == sub) out[n++] = x * 4 + y;
+        }
+}
+
+struct SubFit {
+    int error = INT_MAX;
+    int table = 0;
+    int idx[8] = {};
+};
+
+// Meilleure table et indices pour une couleur de base déjà quantifiée
+SubFit fitSubblock(const Block& b, const int pix[8], const int base[3]) {
+    SubFit best;
+    for (int t = 0; t < 8; ++t) {
+        SubFit f;
+        f.table = t;
+        f.error = 0;
+        for (int i = 0; i < 8; ++i) {
+            const int* c = b.rgb[pix[i]];
+            int bestErr = INT_MAX, bestM = 0;
+            for (int m = 0; m < 4; ++m) {
+                int d = MODIFIERS[t][m];
+                int dr = clamp255(base[0] + d) - c[0];
+                int dg = clamp255(base[1] + d) - c[1];
+                int db = clamp255(base[2] + d) - c[2];
+                int e = dr * dr + dg * dg + db * db;
+                if (e < bestErr) { bestErr = e; bestM = m; }
+            }
+            f.idx[i] = bestM;
+            f.error += bestErr;
+            if (f.error >= best.error) break;
+        }
+        if (f.error < best.error) best = f;
+    }
+    return best;
+}
+
+void average(const Block& b, const int pix[8], float avg[3]) {
+    avg[0] = avg[1] = avg[2] = 0;
+    for (int i = 0; i < 8; ++i)
+        for (int c = 0; c < 3; ++c) avg[c] += b.rgb[pix[i]][c];
+    for (int c = 0; c < 3; ++c) avg[c] /= 8.0f;
+}
+
+// Bits 31..0 : MSB des indices en 31..16, LSB en 15..0 ; valeur m = msb*2 + lsb
+void packIndices(uint32_t& low, const int pix[8], const SubFit& f) {
+    for (int i = 0; i < 8; ++i) {
+        int p = pix[i], m = f.idx[i];
+        low |= (uint32_t)(m >> 1) << (p + 16);
+        low |= (uint32_t)(m & 1) << p;
+    }
+}
+
+void writeBig(unsigned char* dst, uint32_t high, uint32_t low) {
+    for (int i = 0; i < 4; ++i) dst[i] = (unsigned char)(high >> (24 - 8 * i));
+    for (int i = 0; i < 4; ++i) dst[4 + i] = (unsigned char)(low >> (24 - 8 * i));
+}
+
+void encodeBlock(const Block& b, unsigned char out[8]) {
+    int bestError = INT_MAX;
+    uint32_t bestHigh = 0, bestLow = 0;
+
+    for (int flip = 0; flip < 2; ++flip) {
+        int pix[2][8];
+        float avg[2][3];
+        for (int s = 0; s < 2; ++s) {
+            subblockPixels(flip, s, pix[s]);
+            average(b, pix[s], avg[s]);
+        }
+
+        // Mode individuel : deux couleurs 4 bits
+        {
+            int q[2][3], base[2][3];
+            for (int s = 0; s < 2; ++s)
+                for (int c = 0; c < 3; ++c) {
+                    q[s][c] = min(15, max(0, (int)(avg[s][c] / 17.0f + 0.5f)));
+                    base[s][c] = expand4(q[s][c]);
+                }
+            SubFit f0 = fitSubblock(b, pix[0], base[0]);
+            SubFit f1 = fitSubblock(b, pix[1], base[1]);
+            if (f0.error + f1.error < bestError) {
+                bestError = f0.error + f1.error;
+                bestHigh = (uint32_t)q[0][0] << 28 | (uint32_t)q[1][0] << 24
+                         | (uint32_t)q[0][1] << 20 | (uint32_t)q[1][1] << 16
+                         | (uint32_t)q[0][2] << 12 | (uint32_t)q[1][2] << 8
+                         | (uint32_t)f0.table << 5 | (uint32_t)f1.table << 2 | (uint32_t)flip;
+                bestLow = 0;
+                packIndices(bestLow, pix[0], f0);
+                packIndices(bestLow, pix[1], f1);
+            }
+        }
+
+        // Mode différentiel : couleur 5 bits + écart 3 bits signé
+        {
+            int q[2][3], base[2][3];
+            bool ok = true;
+            for (int c = 0; c < 3; ++c) {
+                q[0][c] = min(31, max(0, (int)(avg[0][c] * 31.0f / 255.0f + 0.5f)));
+                q[1][c] = min(31, max(0, (int)(avg[1][c] * 31.0f / 255.0f + 0.5f)));
+                int d = q[1][c] - q[0][c];
+                if (d < -4 || d > 3) ok = false;
+            }
+            if (ok) {
+                for (int s = 0; s < 2; ++s)
+                    for (int c = 0; c < 3; ++c) base[s][c] = expand5(q[s][c]);
+                SubFit f0 = fitSubblock(b, pix[0], base[0]);
+                SubFit f1 = fitSubblock(b, pix[1], base[1]);
+                if (f0.error + f1.error < bestError) {
+                    bestError = f0.error + f1.error;
+                    auto d3 = [](int d) { return (uint32_t)(d & 7); };
+                    bestHigh = (uint32_t)q[0][0] << 27 | d3(q[1][0] - q[0][0]) << 24
+                             | (uint32_t)q[0][1] << 19 | d3(q[1][1] - q[0][1]) << 16
+                             | (uint32_t)q[0][2] << 11 | d3(q[1][2] - q[0][2]) << 8
+                             | (uint32_t)f0.table << 5 | (uint32_t)f1.table << 2 | 2u | (uint32_t)flip;
+                    bestLow = 0;
+                    packIndices(bestLow, pix[0], f0);
+                    packIndices(bestLow, pix[1], f1);
+                }
+            }
+        }
+    }
+    writeBig(out, bestHigh, bestLow);
+}
+
+void decodeBlock(const unsigned char in[8], int rgb[16][3]) {
+    uint32_t high = (uint32_t)in[0] << 24 | (uint32_t)in[1] << 16 | (uint32_t)in[2] << 8 | in[3];
+    uint32_t low = (uint32_t)in[4] << 24 | (uint32_t)in[5] << 16 | (uint32_t)in[6] << 8 | in[7];
+    bool diff = high & 2, flip = high & 1;
+    int base[2][3];
+    for (int c = 0; c < 3; ++c) {
+        int shift = 24 - 8 * c; // R, G, B dans les octets 0..2
+        if (diff) {
+            int c1 = (high >> (shift + 3)) & 31;
+            int d = (high >> shift) & 7;
+            if (d >= 4) d -= 8;
+            base[0][c] = expand5(c1);
+            base[1][c] = expand5((c1 + d) & 31);
+        } else {
+            base[0][c] = expand4((high >> (shift + 4)) & 15);
+            base[1][c] = expand4((high >> shift) & 15);
+        }
+    }
+    int table[2] = {(int)(high >> 5) & 7, (int)(high >> 2) & 7};
+    for (int x = 0; x < 4; ++x)
+        for (int y = 0; y < 4; ++y) {
+            int p = x * 4 + y;
+            int s = flip ? (y >= 2) : (x >= 2);
+            int m = (int)((low >> (p + 16)) & 1) << 1 | (int)((low >> p) & 1);
+            int d = MODIFIERS[table[s]][m];
+            for (int c = 0; c < 3; ++c) rgb[p][c] = clamp255(base[s][c] + d);
+        }
+}
+
+uint32_t readU32(const unsigned char* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+void appendU32(vector<unsigned char>& out, uint32_t v) {
+    unsigned char b[4];
+    memcpy(b, &v, 4);
+    out.insert(out.end(), b, b + 4);
+}
+
+}
+
+size_t etc1Size(int w, int h) {
+    return (size_t)((w + 3) / 4) * ((h + 3) / 4) * 8;
+}
+
+vector<unsigned char> encodeEtc1Image(const ImageRGBA& img, bool alphaPlane) {
+    int bw = (img.w + 3) / 4, bh = (img.h + 3) / 4;
+    vector<unsigned char> out((size_t)bw * bh * 8);
+    Block b;
+    for (int by = 0; by < bh; ++by)
+        for (int bx = 0; bx < bw; ++bx) {
+            for (int x = 0; x < 4; ++x)
+                for (int y = 0; y < 4; ++y) {
+                    // Bords : on répète le dernier pixel
+                    int px = min(bx * 4 + x, img.w - 1), py = min(by * 4 + y, img.h - 1);
+                    const unsigned char* s = &img.pixels[((size_t)py * img.w + px) * 4];
+                    for (int c = 0; c < 3; ++c) b.rgb[x * 4 + y][c] = alphaPlane ? s[3] : s[c];
+                }
+            encodeBlock(b, &out[((size_t)by * bw + bx) * 8]);
+        }
+    return out;
+}
+
+ImageRGBA decodeEtc1Image(const unsigned char* blocks, int w, int h, const unsigned char* alphaBlocks) {
+    ImageRGBA img;
+    img.w = w;
+    img.h = h;
+    img.pixels.assign((size_t)w * h * 4, 255);
+    int bw = (w + 3) / 4, bh = (h + 3) / 4;
+    int rgb[16][3], alpha[16][3];
+    for (int by = 0; by < bh; ++by)
+        for (int bx = 0; bx < bw; ++bx) {
+            size_t off = ((size_t)by * bw + bx) * 8;
+            decodeBlock(blocks + off, rgb);
+            if (alphaBlocks) decodeBlock(alphaBlocks + off, alpha);
+            for (int x = 0; x < 4; ++x)
+                for (int y = 0; y < 4; ++y) {
+                    int px = bx * 4 + x, py = by * 4 + y;
+                    if (px >= w || py >= h) continue;
+                    unsigned char* d = &img.pixels[((size_t)py * w + px) * 4];
+                    for (int c = 0; c < 3; ++c) d[c] = (unsigned char)rgb[x * 4 + y][c];
+                    if (alphaBlocks) d[3] = (unsigned char)alpha[x * 4 + y][1];
+                }
+        }
+    return img;
+}
+
+Etc1Texture encodeEtc1(const MipChain& chain) {
+    Etc1Texture tex;
+    for (const auto& lvl : chain.levels) {
+        for (size_t i = 3; i < lvl.pixels.size() && !tex.hasAlpha; i += 4) tex.hasAlpha = lvl.pixels[i] != 255;
+    }
+    for (const auto& lvl : chain.levels) {
+        Etc1Level e;
+        e.w = lvl.w;
+        e.h = lvl.h;
+        e.color = encodeEtc1Image(lvl, false);
+        if (tex.hasAlpha) e.alpha = encodeEtc1Image(lvl, true);
+        tex.levels.push_back(std::move(e));
+    }
+    return tex;
+}
+
+vector<unsigned char> writeEtc1Container(const Etc1Texture& tex) {
+    vector<unsigned char> out(ETC1_MAGIC, ETC1_MAGIC + 4);
+    appendU32(out, ETC1_VERSION);
+    appendU32(out, (uint32_t)tex.levels.size());
+    appendU32(out, tex.hasAlpha ? ETC1_FLAG_ALPHA : 0);
+    for (const auto& lvl : tex.levels) {
+        appendU32(out, (uint32_t)lvl.w);
+        appendU32(out, (uint32_t)lvl.h);
+        out.insert(out.end(), lvl.color.begin(), lvl.color.end());
+        out.insert(out.end(), lvl.alpha.begin(), lvl.alpha.end());
+    }
+    return out;
+}
+
+bool readEtc1Container(const Blob& blob, Etc1Texture& out) {
+    if (blob.size < 16 || memcmp(blob.data, ETC1_MAGIC, 4) != 0) return false;
+    if (readU32(blob.data + 4) != ETC1_VERSION) return false;
+    uint32_t count = readU32(blob.data + 8);
+    out.hasAlpha = readU32(blob.data + 12) & ETC1_FLAG_ALPHA;
+    out.levels.clear();
+
+    size_t pos = 16;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (pos + 8 > blob.size) return false;
+        Etc1Level lvl;
+        lvl.w = (int)readU32(blob.data + pos);
+        lvl.h = (int)readU32(blob.data + pos + 4);
+        pos += 8;
+        if (lvl.w <= 0 || lvl.h <= 0) return false;
+        size_t n = etc1Size(lvl.w, lvl.h);
+        if (pos + n * (out.hasAlpha ? 2 : 1) > blob.size) return false;
+        lvl.color.assign(blob.data + pos, blob.data + pos + n);
+        pos += n;
+        if (out.hasAlpha) {
+            lvl.alpha.assign(blob.data + pos, blob.data + pos + n);
+            pos += n;
+        }
+        out.levels.push_back(std::move(lvl));
+    }
+    return !out.levels.empty();
+}
+
+string etc1EntryName(const string& textureName) {
+    return textureName + ".etc1";
+}
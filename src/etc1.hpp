@@ -0,0 +1,42 @@
+// etc1.hpp
+#pragma once
+#include "archive.hpp"
+#include "texture.hpp"
+#include <cstdint>
+#include <vector>
+
+// Compression ETC1 (GL_OES_compressed_ETC1_RGB8_texture), 8 octets par bloc 4x4.
+// ETC1 n'a pas d'alpha : il est encodé à part comme une seconde image ETC1 en niveaux de gris.
+
+// Conteneur rangé dans l'archive à côté du PNG ("ground.png" -> "ground.png.etc1"), petit-boutiste :
+//   "OETC", version, nombre de niveaux, drapeaux (1 = plan alpha)
+//   puis par niveau : largeur, hauteur, blocs couleur, blocs alpha éventuels
+constexpr char ETC1_MAGIC[4] = {'O', 'E', 'T', 'C'};
+constexpr uint32_t ETC1_VERSION = 1;
+constexpr uint32_t ETC1_FLAG_ALPHA = 1;
+
+struct Etc1Level {
+    int w = 0, h = 0;
+    std::vector<unsigned char> color; // blocs ETC1
+    std::vector<unsigned char> alpha; // vide sans plan alpha
+};
+
+struct Etc1Texture {
+    std::vector<Etc1Level> levels; // niveau 0 en premier
+    bool hasAlpha = false;
+};
+
+size_t etc1Size(int w, int h); // taille en octets des blocs d'une image w x h
+
+// Encode chaque niveau ; le plan alpha n'est produit que si l'image a des pixels non opaques
+Etc1Texture encodeEtc1(const MipChain& chain);
+std::vector<unsigned char> encodeEtc1Image(const ImageRGBA& img, bool alphaPlane);
+
+// Décodeur de référence CPU (tests sans GPU, repli sans l'extension)
+ImageRGBA decodeEtc1Image(const unsigned char* blocks, int w, int h, const unsigned char* alphaBlocks = nullptr);
+
+std::vector<unsigned char> writeEtc1Container(const Etc1Texture& tex);
+bool readEtc1Container(const Blob& blob, Etc1Texture& out);
+
+// Nom de l'entrée d'archive qui accompagne une texture PNG
+std::string etc1EntryName(const std::string& textureName);
@@ -4,13 +4,27 @@
 #include <filesystem>
 #include <vector>
 #include <string>
+#include <map>
+#include <unordered_map>
 #include <algorithm>
 #include <iostream>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <climits>
+#endif
 
 namespace fs = std::filesystem;
 
 static std::string racine = fs::path(getenv("HOME")).string();
 
+static const int WINDOW_W = 600, WINDOW_H = 440;
+static const int LIST_TOP = 10, LIST_BOTTOM = 390; // la ligne du nom de fichier est en 400
+static const int ROW_HEIGHT = 22;
+static const int WHEEL_ROWS = 3;
+static const size_t LABEL_CACHE_MAX = 1024; // textures de libellés gardées avant de tout vider
+static const Uint32 IDLE_WAIT_MS = 100;     // au repos : attente d'un événement, inotify relu entre deux
+
 struct Entry {
     std::string name;
     std::string path;
@@ -19,112 +33,269 @@ struct Entry {
 };
 
 static void lister(const std::string& path, int depth, std::vector<Entry>& entries) {
-    for (const auto& entry : fs::directory_iterator(path)) {
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(path, ec)) {
         std::string name = entry.path().filename().string();
         if (name.size() && name[0] == '.') continue;
-        entries.push_back({name, entry.path().string(), entry.is_directory(), depth});
+        entries.push_back({name, entry.path().string(), entry.is_directory(ec), depth});
     }
     std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
         return a.name < b.name;
     });
 }
 
+// Contenu des dossiers déjà ouverts, gardé d'une ouverture de la boîte à l'autre.
+// Sous Linux, inotify signale les ajouts, suppressions et renommages : seul un dossier modifié est relu.
+// Ailleurs, un dossier est relu chaque fois qu'on y entre.
+class DirectoryCache {
+public:
+    DirectoryCache() {
+#ifdef __linux__
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+    }
+
+    const std::vector<Entry>& get(const std::string& path) {
+        auto it = listings.find(path);
+        if (it != listings.end() && !it->second.stale) return it->second.entries;
+        Listing& l = listings[path];
+        l.entries.clear();
+        lister(path, 0, l.entries);
+        l.stale = !watch(path);
+        return l.entries;
+    }
+
+    // Relit les événements en attente ; true si un dossier en cache a changé
+    bool poll() {
+        bool changed = false;
+#ifdef __linux__
+        if (fd < 0) return false;
+        alignas(inotify_event) char buf[4096];
+        ssize_t n;
+        while ((n = read(fd, buf, sizeof buf)) > 0) {
+            for (char* p = buf; p < buf + n;) {
+                auto* ev = reinterpret_cast<inotify_event*>(p);
+                p += sizeof(inotify_event) + ev->len;
+                if (ev->mask & IN_Q_OVERFLOW) { // événements perdus : tout est à relire
+                    for (auto& [path, l] : listings) l.stale = true;
+                    changed = true;
+                    continue;
+                }
+                auto w = watches.find(ev->wd);
+                if (w == watches.end()) continue;
+                if (ev->mask & IN_IGNORED) { // dossier supprimé ou démonté : la surveillance est tombée
+                    listings.erase(w->second);
+                    watches.erase(w);
+                } else {
+                    listings[w->second].stale = true;
+                }
+                changed = true;
+            }
+        }
+#endif
+        return changed;
+    }
+
+private:
+    struct Listing {
+        std::vector<Entry> entries;
+        bool stale = false;
+    };
+
+    bool watch(const std::string& path) {
+#ifdef __linux__
+        if (fd < 0) return false;
+        int wd = inotify_add_watch(fd, path.c_str(), IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+        if (wd < 0) return false;
+        watches[wd] = path;
+        return true;
+#else
+        (void)path;
+        return false;
+#endif
+    }
+
+    std::map<std::string, Listing> listings;
+#ifdef __linux__
+    int fd = -1;
+    std::unordered_map<int, std::string> watches;
+#endif
+};
+
+static DirectoryCache& directoryCache() {
+    static DirectoryCache cache;
+    return cache;
+}
+
+// Libellés rendus une fois par TTF puis réutilisés tant que la boîte est ouverte (textures liées au renderer)
+class LabelCache {
+public:
+    LabelCache(SDL_Renderer* r, TTF_Font* font) : r(r), font(font) {}
+    ~LabelCache() { clear(); }
+
+    // nullptr pour un texte vide
+    SDL_Texture* get(const std::string& text, int& w, int& h) {
+        auto it = labels.find(text);
+        if (it == labels.end()) {
+            if (labels.size() >= LABEL_CACHE_MAX) clear(); // défilement d'un très grand dossier
+            Label l;
+            SDL_Surface* surf = TTF_RenderText_Solid(font, text.c_str(), SDL_Color{0, 0, 0, 255});
+            if (surf) {
+                l.tex = SDL_CreateTextureFromSurface(r, surf);
+                l.w = surf->w;
+                l.h = surf->h;
+                SDL_FreeSurface(surf);
+            }
+            it = labels.emplace(text, l).first;
+        }
+        w = it->second.w;
+        h = it->second.h;
+        return it->second.tex;
+    }
+
+    void clear() {
+        for (auto& [text, l] : labels) {
+            if (l.tex) SDL_DestroyTexture(l.tex);
+        }
+        labels.clear();
+    }
+
+private:
+    struct Label {
+        SDL_Texture* tex = nullptr;
+        int w = 0, h = 0;
+    };
+    SDL_Renderer* r;
+    TTF_Font* font;
+    std::unordered_map<std::string, Label> labels;
+};
+
+static void drawLabel(SDL_Renderer* r, LabelCache& labels, const std::string& text, int x, int y) {
+    int w, h;
+    SDL_Texture* tex = labels.get(text, w, h);
+    if (!tex) return;
+    SDL_Rect dst = {x, y, w, h};
+    SDL_RenderCopy(r, tex, NULL, &dst);
+}
+
+// Thread principal, TTF_Init fait par main() : SDL_ttf n'est pas appelé ailleurs en même temps
 std::string ouvrirBoiteFichier(bool saveMode) {
-    TTF_Init();
     TTF_Font* font = TTF_OpenFont("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", 16);
     if (!font) return "";
 
     SDL_Window* win = SDL_CreateWindow(saveMode ? "Enregistrer sous..." : "Choisir un fichier",
-        SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 600, 440, SDL_WINDOW_SHOWN);
+        SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_W, WINDOW_H, SDL_WINDOW_SHOWN);
     SDL_Renderer* r = SDL_CreateRenderer(win, -1, SDL_RENDERER_ACCELERATED);
 
     std::string current = racine;
     std::string selection = "";
     std::string typedFilename = "";
 
-    bool running = true;
-    SDL_StartTextInput();
-    while (running) {
-        std::vector<Entry> liste;
-        lister(current, 0, liste);
-
-        SDL_Event e;
-        while (SDL_PollEvent(&e)) {
-            if (e.type == SDL_QUIT) running = false;
-            if (e.type == SDL_KEYDOWN) {
-                if (e.key.keysym.sym == SDLK_ESCAPE) running = false;
-                if (e.key.keysym.sym == SDLK_BACKSPACE && !typedFilename.empty())
-                    typedFilename.pop_back();
-                if (e.key.keysym.sym == SDLK_RETURN) {
-                    if (!typedFilename.empty()) {
-                        selection = current + "/" + typedFilename;
-                        running = false;
-                    } else if (!selection.empty()) {
-                        running = false;
+    DirectoryCache& dossiers = directoryCache();
+    const std::vector<Entry>* liste = &dossiers.get(current);
+    const int visibleRows = (LIST_BOTTOM - LIST_TOP) / ROW_HEIGHT;
+    int scroll = 0; // première ligne affichée
+    bool dirty = true;
+
+    {
+        LabelCache labels(r, font);
+        bool running = true;
+        SDL_StartTextInput();
+        while (running) {
+            if (dossiers.poll()) {
+                liste = &dossiers.get(current);
+                dirty = true;
+            }
+
+            // Rien à redessiner : on dort jusqu'au prochain événement (inotify relu au plus tard après IDLE_WAIT_MS)
+            SDL_Event e;
+            for (bool got = dirty ? SDL_PollEvent(&e) : SDL_WaitEventTimeout(&e, IDLE_WAIT_MS); got; got = SDL_PollEvent(&e)) {
+                if (e.type == SDL_QUIT) running = false;
+                if (e.type == SDL_WINDOWEVENT) dirty = true;
+                if (e.type == SDL_KEYDOWN) {
+                    if (e.key.keysym.sym == SDLK_ESCAPE) running = false;
+                    if (e.key.keysym.sym == SDLK_BACKSPACE && !typedFilename.empty())
+                        typedFilename.pop_back();
+                    if (e.key.keysym.sym == SDLK_PAGEUP) scroll -= visibleRows;
+                    if (e.key.keysym.sym == SDLK_PAGEDOWN) scroll += visibleRows;
+                    if (e.key.keysym.sym == SDLK_HOME) scroll = 0;
+                    if (e.key.keysym.sym == SDLK_END) scroll = (int)liste->size();
+                    if (e.key.keysym.sym == SDLK_RETURN) {
+                        if (!typedFilename.empty()) {
+                            selection = current + "/" + typedFilename;
+                            running = false;
+                        } else if (!selection.empty()) {
+                            running = false;
+                        }
                     }
+                    dirty = true;
                 }
-            }
-            if (e.type == SDL_TEXTINPUT) {
-                typedFilename += e.text.text;
-            }
-            if (e.type == SDL_MOUSEBUTTONDOWN) {
-                int mx = e.button.x, my = e.button.y;
-                int y = 10;
-                for (auto& entry : liste) {
-                    SDL_Rect rect = {10 + entry.depth * 20, y, 580, 20};
-                    if (my >= y && my <= y + 20) {
+                if (e.type == SDL_TEXTINPUT) {
+                    typedFilename += e.text.text;
+                    dirty = true;
+                }
+                if (e.type == SDL_MOUSEWHEEL) {
+                    scroll -= e.wheel.y * WHEEL_ROWS;
+                    dirty = true;
+                }
+                if (e.type == SDL_MOUSEBUTTONDOWN) {
+                    int my = e.button.y;
+                    int row = (my - LIST_TOP) / ROW_HEIGHT;
+                    size_t index = (size_t)(scroll + row);
+                    if (my >= LIST_TOP && row < visibleRows && index < liste->size()) {
+                        const Entry entry = (*liste)[index]; // copie : liste change si on entre dans un dossier
                         if (entry.is_dir) {
                             current = entry.path;
                             typedFilename = "";
-                            break;
+                            liste = &dossiers.get(current);
+                            scroll = 0;
                         } else {
                             selection = entry.path;
                             typedFilename = fs::path(entry.name).string();
                             if (!saveMode) running = false;
                         }
                     }
-                    y += 22;
+                    dirty = true;
                 }
             }
-        }
+            scroll = std::max(0, std::min(scroll, (int)liste->size() - visibleRows));
+            if (!dirty || !running) continue;
+            dirty = false;
 
-        SDL_SetRenderDrawColor(r, 240, 240, 240, 255);
-        SDL_RenderClear(r);
-
-        int y = 10;
-        for (auto& entry : liste) {
-            std::string label = entry.is_dir ? ("[" + entry.name + "]") : entry.name;
-            SDL_Color color = {0, 0, 0};
-            SDL_Surface* surf = TTF_RenderText_Solid(font, label.c_str(), color);
-            SDL_Texture* tex = SDL_CreateTextureFromSurface(r, surf);
-            SDL_Rect dst = {10 + entry.depth * 20, y, surf->w, surf->h};
-            SDL_RenderCopy(r, tex, NULL, &dst);
-            SDL_FreeSurface(surf);
-            SDL_DestroyTexture(tex);
-            y += 22;
-        }
+            SDL_SetRenderDrawColor(r, 240, 240, 240, 255);
+            SDL_RenderClear(r);
 
-        if (saveMode) {
-            SDL_Color color = {0, 0, 0};
-            std::string prompt = "Nom de fichier: " + typedFilename;
-            SDL_Surface* surf = TTF_RenderText_Solid(font, prompt.c_str(), color);
-            SDL_Texture* tex = SDL_CreateTextureFromSurface(r, surf);
-            SDL_Rect dst = {10, 400, surf->w, surf->h};
-            SDL_RenderCopy(r, tex, NULL, &dst);
-            SDL_FreeSurface(surf);
-            SDL_DestroyTexture(tex);
-        }
+            // Seules les lignes visibles sont dessinées, quelle que soit la taille du dossier
+            size_t fin = std::min(liste->size(), (size_t)(scroll + visibleRows));
+            int y = LIST_TOP;
+            for (size_t i = scroll; i < fin; ++i) {
+                const Entry& entry = (*liste)[i];
+                drawLabel(r, labels, entry.is_dir ? ("[" + entry.name + "]") : entry.name, 10 + entry.depth * 20, y);
+                y += ROW_HEIGHT;
+            }
 
-        SDL_RenderPresent(r);
-        SDL_Delay(26);
+            // Ascenseur : position et part visible de la liste
+            if (liste->size() > (size_t)visibleRows) {
+                int hauteur = LIST_BOTTOM - LIST_TOP;
+                int h = std::max(10, (int)((long long)hauteur * visibleRows / liste->size()));
+                int pos = (int)((long long)(hauteur - h) * scroll / (liste->size() - visibleRows));
+                SDL_Rect barre = {WINDOW_W - 8, LIST_TOP + pos, 4, h};
+                SDL_SetRenderDrawColor(r, 160, 160, 160, 255);
+                SDL_RenderFillRect(r, &barre);
+            }
+
+            if (saveMode) {
+                drawLabel(r, labels, "Nom de fichier: " + typedFilename, 10, 400);
+            }
+
+            SDL_RenderPresent(r);
+        }
+        SDL_StopTextInput();
     }
 
-    SDL_StopTextInput();
     SDL_DestroyRenderer(r);
     SDL_DestroyWindow(win);
     TTF_CloseFont(font);
-    TTF_Quit();
 
     return selection;
 }
-
@@ -0,0 +1,140 @@
+// fill_analysis.cpp
+#include "fill_analysis.hpp"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <memory>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const int HEAT_MAX = 4; // surdessin à partir duquel la couleur sature
+
+AlphaCoverage::AlphaCoverage(const ImageRGBA& img) : w(img.w), h(img.h), prefix((size_t)(img.w + 1) * img.h) {
+    for (int y = 0; y < h; ++y) {
+        const unsigned char* alpha = &img.pixels[(size_t)y * w * 4 + 3];
+        uint32_t* row = &prefix[(size_t)y * (w + 1)];
+        uint32_t n = 0;
+        row[0] = 0;
+        for (int x = 0; x < w; ++x) {
+            n += alpha[(size_t)x * 4] == 0;
+            row[x + 1] = n;
+        }
+    }
+}
+
+// Segments de lignes : centres de texels (x + 0.5, y + 0.5) à l'intérieur du triangle, bornés à la texture
+template <typename Span>
+static void rasterize(const float (&px)[3], const float (&py)[3], int w, int h, Span span) {
+    float minY = min({py[0], py[1], py[2]}), maxY = max({py[0], py[1], py[2]});
+    int y0 = max(0, (int)ceil(minY - 0.5f)), y1 = min(h - 1, (int)floor(maxY - 0.5f));
+    for (int y = y0; y <= y1; ++y) {
+        float yc = y + 0.5f;
+        float xl = INFINITY, xr = -INFINITY;
+        for (int e = 0; e < 3; ++e) {
+            int f = (e + 1) % 3;
+            if ((py[e] <= yc) == (py[f] <= yc)) continue; // arête qui ne traverse pas la ligne
+            float x = px[e] + (yc - py[e]) * (px[f] - px[e]) / (py[f] - py[e]);
+            xl = min(xl, x);
+            xr = max(xr, x);
+        }
+        if (xl > xr) continue;
+        int x0 = max(0, (int)ceil(xl - 0.5f)), x1 = min(w, (int)ceil(xr - 0.5f));
+        if (x0 < x1) span(y, x0, x1);
+    }
+}
+
+FillStats analyzeSurface(const Surfaces& s, const AlphaCoverage& alpha, vector<uint16_t>* heat) {
+    FillStats stats;
+    int w = alpha.width(), h = alpha.height();
+    for (size_t i = 0; i + 2 < s.cornerCount(); i += 3) {
+        float px[3], py[3];
+        for (int k = 0; k < 3; ++k) {
+            const Point5D& p = s.corner(i + k);
+            px[k] = p.u * w;
+            py[k] = p.v * h;
+        }
+        rasterize(px, py, w, h, [&](int y, int x0, int x1) {
+            stats.covered += x1 - x0;
+            stats.transparent += alpha.transparentIn(y, x0, x1);
+            if (heat) {
+                uint16_t* row = &(*heat)[(size_t)y * w];
+                for (int x = x0; x < x1; ++x) row[x] += row[x] < UINT16_MAX;
+            }
+        });
+    }
+    return stats;
+}
+
+bool writeHeatmap(const string& path, const ImageRGBA& texture, const vector<uint16_t>& heat) {
+    ImageRGBA out;
+    out.w = texture.w;
+    out.h = texture.h;
+    out.pixels.resize(texture.pixels.size());
+    for (size_t i = 0; i < heat.size(); ++i) {
+        bool opaque = texture.pixels[i * 4 + 3] != 0;
+        unsigned char* p = &out.pixels[i * 4];
+        int n = min<int>(heat[i], HEAT_MAX);
+        unsigned char intensite = (unsigned char)(n ? 95 + 160 * n / HEAT_MAX : 0);
+        p[0] = opaque ? 0 : intensite;
+        p[1] = opaque ? intensite : 0;
+        p[2] = (opaque && n == 0) ? 255 : 0;
+        p[3] = 255;
+    }
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(out.pixels.data(), out.w, out.h, 32, out.w * 4,
+                                                              SDL_PIXELFORMAT_RGBA32);
+    if (!surface) return false;
+    bool ok = IMG_SavePNG(surface, path.c_str()) == 0;
+    SDL_FreeSurface(surface);
+    return ok;
+}
+
+ObjxFill analyzeObjx(const Objx& objx, const string& heatmapDir) {
+    struct Texture {
+        ImageRGBA img;
+        unique_ptr<AlphaCoverage> alpha;
+        vector<uint16_t> heat;
+    };
+    map<string, Texture> textures; // par nom : chaque texture décodée une fois
+    ObjxFill result;
+    const auto& surfaces = objx.getSurfaces();
+    for (size_t i = 0; i < surfaces.size(); ++i) {
+        const Surfaces& s = surfaces[i];
+        if (s.texture.empty() || s.cornerCount() < 3) continue;
+        string name = fs::path(s.texture).filename().string();
+        auto it = textures.find(name);
+        if (it == textures.end()) {
+            Texture t;
+            const Blob* png = objx.getEmbedded(name);
+            bool ok = png ? decodeImage(*png, t.img) : decodeImageFile(s.texture, t.img);
+            if (ok) {
+                t.alpha = make_unique<AlphaCoverage>(t.img);
+                if (!heatmapDir.empty()) t.heat.assign((size_t)t.img.w * t.img.h, 0);
+            }
+            it = textures.emplace(name, std::move(t)).first;
+        }
+        Texture& t = it->second;
+        if (!t.alpha) continue; // texture illisible
+
+        SurfaceFill f;
+        f.index = i;
+        f.texture = name;
+        f.stats = analyzeSurface(s, *t.alpha, heatmapDir.empty() ? nullptr : &t.heat);
+        result.total.add(f.stats);
+        result.surfaces.push_back(f);
+    }
+
+    if (!heatmapDir.empty()) {
+        fs::create_directories(heatmapDir);
+        for (auto& [name, t] : textures) {
+            if (!t.alpha) continue;
+            string path = (fs::path(heatmapDir) / (name + ".fill.png")).string();
+            if (!writeHeatmap(path, t.img, t.heat)) cerr << "[fill] écriture impossible : " << path << endl;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,60 @@
+// fill_analysis.hpp
+#pragma once
+#include "objx.hpp"
+#include "texture.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Remplissage perdu : texels couverts par les triangles d'une surface mais entièrement transparents
+// (alpha nul), que le fragment shader échantillonne quand même. Mesuré dans l'espace de la texture
+// (u * largeur, v * hauteur) : le rapport vaut pour n'importe quelle taille à l'écran.
+// Les UV hors de [0,1] (GL_CLAMP_TO_EDGE) ne sont pas comptées.
+
+struct FillStats {
+    uint64_t covered = 0;     // texels couverts, une fois par triangle (le surdessin compte)
+    uint64_t transparent = 0; // parmi eux, ceux d'alpha nul
+    double wastedRatio() const { return covered ? (double)transparent / covered : 0.0; }
+    void add(const FillStats& o) {
+        covered += o.covered;
+        transparent += o.transparent;
+    }
+};
+
+// Alpha d'une texture préparé pour l'analyse : par ligne, nombre cumulé de texels transparents,
+// donc un segment de triangle se compte en une soustraction
+class AlphaCoverage {
+public:
+    explicit AlphaCoverage(const ImageRGBA& img);
+    int width() const { return w; }
+    int height() const { return h; }
+    uint32_t transparentIn(int y, int x0, int x1) const { // texels transparents de [x0, x1) sur la ligne y
+        const uint32_t* row = &prefix[(size_t)y * (w + 1)];
+        return row[x1] - row[x0];
+    }
+
+private:
+    int w, h;
+    std::vector<uint32_t> prefix; // w + 1 entrées par ligne
+};
+
+// heat (w * h, facultatif) : reçoit, par texel, le nombre de triangles qui le couvrent
+FillStats analyzeSurface(const Surfaces& s, const AlphaCoverage& alpha, std::vector<uint16_t>* heat = nullptr);
+
+struct SurfaceFill {
+    size_t index = 0;    // dans getSurfaces()
+    std::string texture; // nom de fichier
+    FillStats stats;
+};
+
+struct ObjxFill {
+    std::vector<SurfaceFill> surfaces; // surfaces texturées analysées
+    FillStats total;
+};
+
+// Textures prises dans l'archive, sinon sur le disque. heatmapDir non vide : une image par texture,
+// "<texture>.fill.png" (rouge : transparent couvert, vert : opaque couvert, plus clair = plus de surdessin ;
+// bleu : opaque non couvert, donc coupé par le mesh)
+ObjxFill analyzeObjx(const Objx& objx, const std::string& heatmapDir = "");
+
+bool writeHeatmap(const std::string& path, const ImageRGBA& texture, const std::vector<uint16_t>& heat);
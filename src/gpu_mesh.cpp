@@ -0,0 +1,141 @@
+// gpu_mesh.cpp
+#include "gpu_mesh.hpp"
+#include "mesh_index.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+void GpuMeshCache::setAttributes(GLint position, GLint texCoord) {
+    positionLoc = position;
+    texCoordLoc = texCoord;
+}
+
+void GpuMeshCache::setDequantization(GLint posMin, GLint posExtent, GLint uvRange) {
+    posMinLoc = posMin;
+    posExtentLoc = posExtent;
+    uvRangeLoc = uvRange;
+}
+
+// Envoie les sommets dans le format choisi ; points est soit s.points soit sa réexpansion
+static void uploadVertices(const std::vector<Point5D>& points, bool packed, Dequantization& dequant) {
+    if (packed) {
+        dequant = Dequantization::of(points);
+        std::vector<PackedVertex> q = quantize(points, dequant);
+        glBufferData(GL_ARRAY_BUFFER, q.size() * sizeof(PackedVertex), q.data(), GL_STATIC_DRAW);
+        PROFILE_COUNT(Counter::BytesUploaded, q.size() * sizeof(PackedVertex));
+    } else {
+        glBufferData(GL_ARRAY_BUFFER, points.size() * sizeof(Point5D), points.data(), GL_STATIC_DRAW);
+        PROFILE_COUNT(Counter::BytesUploaded, points.size() * sizeof(Point5D));
+    }
+}
+
+bool GpuMeshCache::supportsUintIndices() {
+    if (uintIndices < 0) {
+        const char* ext = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+        uintIndices = ext && strstr(ext, "GL_OES_element_index_uint") ? 1 : 0;
+    }
+    return uintIndices == 1;
+}
+
+GpuMeshCache::Entry& GpuMeshCache::sync(const Surfaces& s) {
+    Entry& e = entries[&s];
+    bool stale = e.vbo == 0 || e.revision != s.revision
+              || e.pointCount != s.points.size() || e.data != s.points.data()
+              || e.indexData != s.indices.data();
+    if (!stale) return e;
+
+    if (e.vbo == 0) glGenBuffers(1, &e.vbo);
+    e.revision = s.revision;
+    e.data = s.points.data();
+    e.indexData = s.indices.data();
+    e.pointCount = s.points.size();
+    e.packed = posMinLoc >= 0 && posExtentLoc >= 0 && uvRangeLoc >= 0;
+
+    size_t indexCount = s.indices.size() - s.indices.size() % 3;
+    bool small = s.points.size() <= 65536;
+    if (indexCount == 0 || (!small && !supportsUintIndices())) {
+        // Soupe de triangles, ou index 32 bits non gérés par le GPU : on réexpanse
+        std::vector<Point5D> soup = expandTriangles(s);
+        glBindBuffer(GL_ARRAY_BUFFER, e.vbo);
+        uploadVertices(soup, e.packed, e.dequant);
+        e.count = (GLsizei)(soup.size() - soup.size() % 3);
+        e.indexType = 0;
+        return e;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, e.vbo);
+    uploadVertices(s.points, e.packed, e.dequant);
+
+    if (e.ibo == 0) glGenBuffers(1, &e.ibo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, e.ibo);
+    if (small) {
+        std::vector<uint16_t> idx16(s.indices.begin(), s.indices.begin() + indexCount);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, idx16.size() * sizeof(uint16_t), idx16.data(), GL_STATIC_DRAW);
+        e.indexType = GL_UNSIGNED_SHORT;
+        PROFILE_COUNT(Counter::BytesUploaded, idx16.size() * sizeof(uint16_t));
+    } else {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(uint32_t), s.indices.data(), GL_STATIC_DRAW);
+        e.indexType = GL_UNSIGNED_INT;
+        PROFILE_COUNT(Counter::BytesUploaded, indexCount * sizeof(uint32_t));
+    }
+    e.count = (GLsizei)indexCount;
+    return e;
+}
+
+void GpuMeshCache::upload(const Surfaces& s) {
+    sync(s);
+}
+
+void GpuMeshCache::draw(const Surfaces& s) {
+    drawRange(s, 0, s.cornerCount());
+}
+
+void GpuMeshCache::drawRange(const Surfaces& s, size_t first, size_t count) {
+    if (s.cornerCount() < 3) return;
+    Entry& e = sync(s);
+    if (first >= (size_t)e.count) return;
+    count = std::min(count, (size_t)e.count - first);
+    if (count < 3) return;
+
+    PROFILE_COUNT(Counter::DrawCalls, 1);
+    PROFILE_COUNT(Counter::Vertices, count);
+    glBindBuffer(GL_ARRAY_BUFFER, e.vbo);
+    if (e.packed) {
+        const Dequantization& d = e.dequant;
+        glUniform3fv(posMinLoc, 1, d.posMin);
+        glUniform3fv(posExtentLoc, 1, d.posExtent);
+        glUniform4f(uvRangeLoc, d.uvMin[0], d.uvMin[1], d.uvExtent[0], d.uvExtent[1]);
+        glVertexAttribPointer(positionLoc, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (const void*)offsetof(PackedVertex, x));
+        glVertexAttribPointer(texCoordLoc, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (const void*)offsetof(PackedVertex, u));
+    } else {
+        glVertexAttribPointer(positionLoc, 3, GL_FLOAT, GL_FALSE, sizeof(Point5D), (const void*)offsetof(Point5D, x));
+        glVertexAttribPointer(texCoordLoc, 2, GL_FLOAT, GL_FALSE, sizeof(Point5D), (const void*)offsetof(Point5D, u));
+    }
+    glEnableVertexAttribArray(positionLoc);
+    glEnableVertexAttribArray(texCoordLoc);
+
+    if (e.indexType) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, e.ibo);
+        size_t indexSize = e.indexType == GL_UNSIGNED_SHORT ? 2 : 4;
+        glDrawElements(GL_TRIANGLES, (GLsizei)count, e.indexType, (const void*)(first * indexSize));
+    } else {
+        glDrawArrays(GL_TRIANGLES, (GLint)first, (GLsizei)count);
+    }
+}
+
+void GpuMeshCache::release(const Surfaces& s) {
+    auto it = entries.find(&s);
+    if (it == entries.end()) return;
+    glDeleteBuffers(1, &it->second.vbo);
+    if (it->second.ibo) glDeleteBuffers(1, &it->second.ibo);
+    entries.erase(it);
+}
+
+void GpuMeshCache::clear() {
+    for (auto& [surf, e] : entries) {
+        glDeleteBuffers(1, &e.vbo);
+        if (e.ibo) glDeleteBuffers(1, &e.ibo);
+    }
+    entries.clear();
+}
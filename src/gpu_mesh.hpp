@@ -0,0 +1,44 @@
+// gpu_mesh.hpp
+#pragma once
+#include "objx.hpp"
+#include "vertex_quant.hpp"
+#include <SDL2/SDL_opengles2.h>
+#include <unordered_map>
+
+// Un VBO (+ IBO si la surface est indexée) par Surfaces, envoyé une seule fois puis réutilisé à chaque frame.
+// Les Surfaces sont identifiées par adresse : elles ne bougent pas tant que les Objx sont déplacés (move), pas copiés.
+class GpuMeshCache {
+public:
+    void setAttributes(GLint position, GLint texCoord); // emplacements résolus une fois après le link
+    // Sommets envoyés en PackedVertex (12 octets au lieu de 20) : le shader reçoit la déquantification
+    // de chaque surface dans ces uniformes (vec3 min, vec3 étendue, vec4 UV min + étendue)
+    void setDequantization(GLint posMin, GLint posExtent, GLint uvRange);
+
+    void upload(const Surfaces& s);  // (ré)envoie si absent ou si s.revision a changé
+    void draw(const Surfaces& s);    // un seul glDrawElements (ou glDrawArrays) pour toute la surface
+    void drawRange(const Surfaces& s, size_t first, size_t count); // coins [first, first+count) seulement
+    void release(const Surfaces& s); // à appeler avant de détruire la surface
+    void clear();
+
+private:
+    struct Entry {
+        GLuint vbo = 0;
+        GLuint ibo = 0;
+        GLsizei count = 0;       // sommets dessinés (indices, ou points de la soupe)
+        GLenum indexType = 0;    // 0 = glDrawArrays
+        unsigned revision = 0;
+        const Point5D* data = nullptr; // détecte un vecteur de points remplacé
+        const uint32_t* indexData = nullptr;
+        size_t pointCount = 0;
+        bool packed = false;
+        Dequantization dequant;
+    };
+    Entry& sync(const Surfaces& s);
+    bool supportsUintIndices();
+
+    std::unordered_map<const Surfaces*, Entry> entries;
+    GLint positionLoc = 0;
+    GLint texCoordLoc = 1;
+    int uintIndices = -1; // GL_OES_element_index_uint, testé au premier besoin
+    GLint posMinLoc = -1, posExtentLoc = -1, uvRangeLoc = -1; // -1 : sommets en floats
+};
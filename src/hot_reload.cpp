@@ -0,0 +1,76 @@
+// hot_reload.cpp
+#include "hot_reload.hpp"
+#include "profiler.hpp"
+#include <filesystem>
+#include <iostream>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static bool isArchive(const fs::path& p) {
+    return p.extension() == ".plxl" || p.extension() == ".objx";
+}
+
+HotReload::HotReload(const string& directory, ThreadPool& pool, Scene& scene)
+    : watcher(directory), pool(pool), scene(scene) {}
+
+void HotReload::reopen(const string& path) {
+    Pending& p = pending[path];
+    p.objx = pool.submit([path]() { return Objx::open(path, ArchiveAccess::Copied); });
+    p.debut = chrono::steady_clock::now();
+    p.again = false;
+}
+
+void HotReload::update() {
+    PROFILE_SCOPE("hot reload");
+    watcher.poll(changes);
+    for (const auto& c : changes) {
+        fs::path p(c.path);
+        if (isArchive(p)) {
+            if (c.kind == AssetWatcher::Kind::Removed) {
+                int index = scene.indexOf(c.path);
+                if (index >= 0) {
+                    scene.remove(index);
+                    cout << "[hot-reload] " << c.path << " retiré" << endl;
+                }
+            } else if (pending.count(c.path)) {
+                pending[c.path].again = true;
+            } else {
+                reopen(c.path);
+            }
+        } else if (c.kind == AssetWatcher::Kind::Changed) {
+            // Texture externe (ou tout autre fichier référencé par nom) : les objets concernés seulement
+            for (size_t index : scene.objectsUsingFile(p.filename().string())) {
+                scene.refresh(index);
+                cout << "[hot-reload] " << c.path << " : objet " << index << " reconstruit" << endl;
+            }
+        }
+    }
+
+    for (auto it = pending.begin(); it != pending.end();) {
+        Pending& p = it->second;
+        if (p.objx.wait_for(chrono::seconds(0)) != future_status::ready) {
+            ++it;
+            continue;
+        }
+        Objx objx = p.objx.get();
+        string path = it->first;
+        if (p.again) {
+            reopen(path);
+            ++it;
+            continue;
+        }
+        auto debut = p.debut;
+        it = pending.erase(it);
+        if (!fs::exists(path)) continue; // supprimée pendant la lecture
+        if (objx.getEmplacement().empty()) {
+            cerr << "[hot-reload] " << path << " illisible, l'ancienne version reste affichée" << endl;
+            continue;
+        }
+        int index = scene.indexOf(path);
+        if (index >= 0) scene.replace(index, std::move(objx));
+        else scene.add(std::move(objx));
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - debut).count();
+        cout << "[hot-reload] " << path << (index >= 0 ? " rechargé" : " ajouté") << " en " << ms << " ms" << endl;
+    }
+}
@@ -0,0 +1,36 @@
+// hot_reload.hpp
+#pragma once
+#include "asset_watcher.hpp"
+#include "objx.hpp"
+#include "scene.hpp"
+#include "thread_pool.hpp"
+#include <chrono>
+#include <future>
+#include <map>
+#include <string>
+#include <vector>
+
+// Rechargement à chaud du dossier d'assets : une archive modifiée est rouverte sur le pool puis échangée
+// dans la scène entre deux frames ; une archive ajoutée est ajoutée, une supprimée retirée. Une texture
+// externe modifiée reconstruit seulement les objets qui l'utilisent. Le reste de la scène ne bouge pas,
+// et les textures dont le contenu n'a pas changé restent sur le GPU (registre par contenu de Scene).
+class HotReload {
+public:
+    HotReload(const std::string& directory, ThreadPool& pool, Scene& scene);
+
+    void update(); // thread GL, une fois par frame
+
+private:
+    struct Pending {
+        std::future<Objx> objx;
+        std::chrono::steady_clock::time_point debut;
+        bool again = false; // modifiée de nouveau pendant la lecture : résultat périmé
+    };
+    void reopen(const std::string& path);
+
+    AssetWatcher watcher;
+    ThreadPool& pool;
+    Scene& scene;
+    std::map<std::string, Pending> pending; // par chemin d'archive
+    std::vector<AssetWatcher::Change> changes;
+};
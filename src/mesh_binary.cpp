@@ -0,0 +1,226 @@
+// mesh_binary.cpp
+#include "mesh_binary.hpp"
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static size_t align4(size_t n) {
+    return (n + 3) & ~size_t(3);
+}
+
+static void readIndices(const unsigned char* src, uint32_t count, uint32_t indexSize, vector<uint32_t>& out) {
+    out.resize(count);
+    if (indexSize == 4) {
+        if (count) memcpy(out.data(), src, (size_t)count * 4);
+        return;
+    }
+    for (uint32_t k = 0; k < count; ++k) {
+        uint16_t v;
+        memcpy(&v, src + k * 2, 2);
+        out[k] = v;
+    }
+}
+
+static void writeIndices(const vector<uint32_t>& idx, uint32_t indexSize, unsigned char* w) {
+    if (indexSize == 4) {
+        if (!idx.empty()) memcpy(w, idx.data(), idx.size() * 4);
+        return;
+    }
+    for (size_t k = 0; k < idx.size(); ++k) {
+        uint16_t v = (uint16_t)idx[k];
+        memcpy(w + k * 2, &v, 2);
+    }
+}
+
+// Bloc des niveaux : nombre, tailles, puis indices
+static size_t lodBlockSize(const Surfaces& s, uint32_t indexSize) {
+    if (s.lods.empty()) return 0;
+    size_t n = 4 + s.lods.size() * 4;
+    for (const auto& level : s.lods) n += level.size() * indexSize;
+    return align4(n);
+}
+
+static bool readLods(const unsigned char* data, size_t size, const MeshBinarySurface& entry, vector<vector<uint32_t>>& lods) {
+    uint32_t count;
+    if (entry.lodOffset > size || size - entry.lodOffset < 4) return false;
+    memcpy(&count, data + entry.lodOffset, 4);
+    size_t pos = entry.lodOffset + 4;
+    if ((size - pos) / 4 < count) return false;
+    vector<uint32_t> counts(count);
+    if (count) memcpy(counts.data(), data + pos, (size_t)count * 4);
+    pos += (size_t)count * 4;
+    lods.resize(count);
+    for (uint32_t l = 0; l < count; ++l) {
+        size_t bytes = (size_t)counts[l] * entry.indexSize;
+        if (bytes > size - pos) return false;
+        readIndices(data + pos, counts[l], entry.indexSize, lods[l]);
+        pos += bytes;
+    }
+    return true;
+}
+
+bool isMeshBinary(const unsigned char* data, size_t size) {
+    return size >= sizeof(MeshBinaryHeader) && memcmp(data, MESH_BINARY_MAGIC, 4) == 0;
+}
+
+bool readMeshBinary(const unsigned char* data, size_t size, vector<Surfaces>& out) {
+    if (!isMeshBinary(data, size)) return false;
+
+    MeshBinaryHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.version == 0 || header.version > MESH_BINARY_VERSION) {
+        cerr << "[meshb] version inconnue : " << header.version << endl;
+        return false;
+    }
+    size_t entrySize = header.version == 1 ? MESH_BINARY_SURFACE_V1_SIZE
+                     : header.version < 4 ? MESH_BINARY_SURFACE_V3_SIZE : sizeof(MeshBinarySurface);
+
+    size_t tableEnd = sizeof(header) + (size_t)header.surfaceCount * entrySize;
+    size_t namesEnd = tableEnd + header.namesSize;
+    if (tableEnd > size || namesEnd > size) {
+        cerr << "[meshb] fichier tronqué" << endl;
+        return false;
+    }
+    const char* names = reinterpret_cast<const char*>(data + tableEnd);
+
+    out.reserve(out.size() + header.surfaceCount);
+    for (uint32_t i = 0; i < header.surfaceCount; ++i) {
+        MeshBinarySurface entry = {};
+        memcpy(&entry, data + sizeof(header) + i * entrySize, entrySize);
+
+        bool packed = entry.pointFormat == MESH_POINTS_UNORM16;
+        if (entry.pointFormat != MESH_POINTS_FLOAT && !packed) {
+            cerr << "[meshb] surface " << i << " : format de points inconnu " << entry.pointFormat << endl;
+            return false;
+        }
+        size_t bytes = (size_t)entry.pointCount * (packed ? sizeof(PackedVertex) : sizeof(Point5D));
+        size_t indexBytes = (size_t)entry.indexCount * entry.indexSize;
+        if ((size_t)entry.textureOffset + entry.textureLength > header.namesSize
+            || entry.pointsOffset > size || bytes > size - entry.pointsOffset
+            || (entry.indexCount && entry.indexSize != 2 && entry.indexSize != 4)
+            || entry.indicesOffset > size || indexBytes > size - entry.indicesOffset) {
+            cerr << "[meshb] surface " << i << " hors limites" << endl;
+            return false;
+        }
+        if (entry.pointCount == 0) continue;
+
+        Surfaces surf;
+        surf.texture.assign(names + entry.textureOffset, entry.textureLength);
+        surf.points.resize(entry.pointCount);
+        if (packed) {
+            const unsigned char* src = data + entry.pointsOffset;
+            for (uint32_t k = 0; k < entry.pointCount; ++k) {
+                PackedVertex q;
+                memcpy(&q, src + k * sizeof(PackedVertex), sizeof(q));
+                surf.points[k] = dequantize(q, entry.dequant);
+            }
+        } else {
+            memcpy(surf.points.data(), data + entry.pointsOffset, bytes);
+        }
+
+        readIndices(data + entry.indicesOffset, entry.indexCount, entry.indexSize, surf.indices);
+        if (header.version >= 3 && entry.lodOffset && !readLods(data, size, entry, surf.lods)) {
+            cerr << "[meshb] surface " << i << " : niveaux de détail hors limites" << endl;
+            return false;
+        }
+        for (uint32_t v : surf.indices) {
+            if (v >= entry.pointCount) {
+                cerr << "[meshb] surface " << i << " : indice hors limites" << endl;
+                return false;
+            }
+        }
+        for (const auto& level : surf.lods) {
+            for (uint32_t v : level) {
+                if (v >= entry.pointCount) {
+                    cerr << "[meshb] surface " << i << " : indice de niveau hors limites" << endl;
+                    return false;
+                }
+            }
+        }
+        out.push_back(std::move(surf));
+    }
+    return true;
+}
+
+vector<unsigned char> writeMeshBinary(const vector<Surfaces>& surfaces, bool quantize) {
+    MeshBinaryHeader header;
+    memcpy(header.magic, MESH_BINARY_MAGIC, 4);
+    header.version = MESH_BINARY_VERSION;
+    header.surfaceCount = (uint32_t)surfaces.size();
+
+    string names;
+    vector<MeshBinarySurface> table(surfaces.size());
+    for (size_t i = 0; i < surfaces.size(); ++i) {
+        string tex = fs::path(surfaces[i].texture).filename().string();
+        table[i].textureOffset = (uint32_t)names.size();
+        table[i].textureLength = (uint32_t)tex.size();
+        names += tex;
+    }
+    names.resize(align4(names.size()), '\0');
+    header.namesSize = (uint32_t)names.size();
+
+    size_t offset = sizeof(header) + table.size() * sizeof(MeshBinarySurface) + names.size();
+    vector<vector<PackedVertex>> packed(quantize ? surfaces.size() : 0);
+    for (size_t i = 0; i < surfaces.size(); ++i) {
+        table[i].pointsOffset = (uint32_t)offset;
+        table[i].pointCount = (uint32_t)surfaces[i].points.size();
+        if (quantize) {
+            table[i].pointFormat = MESH_POINTS_UNORM16;
+            table[i].dequant = Dequantization::of(surfaces[i].points);
+            packed[i] = ::quantize(surfaces[i].points, table[i].dequant);
+            offset += packed[i].size() * sizeof(PackedVertex);
+        } else {
+            table[i].pointFormat = MESH_POINTS_FLOAT;
+            offset += surfaces[i].points.size() * sizeof(Point5D);
+        }
+    }
+    for (size_t i = 0; i < surfaces.size(); ++i) {
+        table[i].indicesOffset = (uint32_t)offset;
+        table[i].indexCount = (uint32_t)surfaces[i].indices.size();
+        table[i].indexSize = surfaces[i].points.size() <= 65536 ? 2 : 4;
+        offset = align4(offset + surfaces[i].indices.size() * table[i].indexSize);
+    }
+    for (size_t i = 0; i < surfaces.size(); ++i) {
+        size_t bytes = surfaces[i].indices.empty() ? 0 : lodBlockSize(surfaces[i], table[i].indexSize);
+        table[i].lodOffset = bytes ? (uint32_t)offset : 0;
+        offset += bytes;
+    }
+
+    vector<unsigned char> buffer(offset);
+    unsigned char* w = buffer.data();
+    memcpy(w, &header, sizeof(header));
+    w += sizeof(header);
+    if (!table.empty()) memcpy(w, table.data(), table.size() * sizeof(MeshBinarySurface));
+    w += table.size() * sizeof(MeshBinarySurface);
+    if (!names.empty()) memcpy(w, names.data(), names.size());
+    w += names.size();
+    for (size_t i = 0; i < surfaces.size(); ++i) {
+        if (surfaces[i].points.empty()) continue;
+        if (quantize) memcpy(buffer.data() + table[i].pointsOffset, packed[i].data(), packed[i].size() * sizeof(PackedVertex));
+        else memcpy(buffer.data() + table[i].pointsOffset, surfaces[i].points.data(), surfaces[i].points.size() * sizeof(Point5D));
+    }
+    for (size_t i = 0; i < surfaces.size(); ++i) {
+        writeIndices(surfaces[i].indices, table[i].indexSize, buffer.data() + table[i].indicesOffset);
+    }
+    for (size_t i = 0; i < surfaces.size(); ++i) {
+        if (!table[i].lodOffset) continue;
+        const auto& lods = surfaces[i].lods;
+        w = buffer.data() + table[i].lodOffset;
+        uint32_t count = (uint32_t)lods.size();
+        memcpy(w, &count, 4);
+        w += 4;
+        for (const auto& level : lods) {
+            uint32_t n = (uint32_t)level.size();
+            memcpy(w, &n, 4);
+            w += 4;
+        }
+        for (const auto& level : lods) {
+            writeIndices(level, table[i].indexSize, w);
+            w += level.size() * table[i].indexSize;
+        }
+    }
+    return buffer;
+}
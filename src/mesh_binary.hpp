@@ -0,0 +1,59 @@
+// mesh_binary.hpp
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "objx.hpp"
+#include "vertex_quant.hpp"
+
+// Format binaire du mesh (entrée "map.meshb" dans l'archive), petit-boutiste :
+//   En-tête      : "OMSH", version, nombre de surfaces, taille de la table des noms
+//   Table        : par surface, offset des points, nombre de points, offset et longueur du nom de texture,
+//                  offset, nombre et taille (2 ou 4 octets) des indices (version 2)
+//   Noms         : noms de texture bout à bout, complétés à 4 octets
+//   Points       : tableaux de Point5D (5 floats) compacts, alignés sur 4 octets ; en version 4, au choix
+//                  par surface, PackedVertex (16 bits normalisés) et leur déquantification dans la table
+//   Indices      : triangles en 16 bits si la surface a au plus 65536 sommets, sinon 32 bits
+//   Niveaux      : (version 3) par surface qui en a, nombre de niveaux, nombre d'indices de chacun,
+//                  puis leurs indices bout à bout, de même taille que ceux du maillage complet
+// Le lecteur travaille sur une simple vue mémoire (entrée d'archive ou fichier mmap).
+
+constexpr char MESH_BINARY_MAGIC[4] = {'O', 'M', 'S', 'H'};
+constexpr uint32_t MESH_BINARY_VERSION = 4; // versions 1 (sans indices), 2 (sans niveaux), 3 (floats seuls) lisibles
+
+struct MeshBinaryHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t surfaceCount;
+    uint32_t namesSize;
+};
+
+struct MeshBinarySurface {
+    uint32_t pointsOffset; // depuis le début du buffer
+    uint32_t pointCount;
+    uint32_t textureOffset; // depuis le début de la table des noms
+    uint32_t textureLength;
+    uint32_t indicesOffset; // à partir d'ici : version 2
+    uint32_t indexCount;    // 0 = soupe de triangles
+    uint32_t indexSize;     // 2 ou 4
+    uint32_t lodOffset;     // version 3 : bloc des niveaux de détail, 0 = aucun
+    uint32_t pointFormat;   // version 4 : MeshPointFormat
+    Dequantization dequant; // version 4, points PackedVertex
+    uint32_t reserved;
+};
+
+enum MeshPointFormat : uint32_t { MESH_POINTS_FLOAT = 0, MESH_POINTS_UNORM16 = 1 };
+
+constexpr size_t MESH_BINARY_SURFACE_V1_SIZE = 16;
+constexpr size_t MESH_BINARY_SURFACE_V3_SIZE = 32;
+
+static_assert(sizeof(Point5D) == 5 * sizeof(float), "Point5D doit rester compact");
+static_assert(sizeof(MeshBinaryHeader) == 16 && sizeof(MeshBinarySurface) == 80, "en-têtes binaires compacts");
+
+bool isMeshBinary(const unsigned char* data, size_t size);
+
+// Ajoute à out les surfaces non vides ; une seule copie par surface, aucune allocation par sommet
+bool readMeshBinary(const unsigned char* data, size_t size, std::vector<Surfaces>& out);
+
+// Les textures sont enregistrées par nom de fichier, comme dans le format texte.
+// quantize : points en PackedVertex (12 octets au lieu de 20), relus en floats à quelques 1e-5 près de la boîte
+std::vector<unsigned char> writeMeshBinary(const std::vector<Surfaces>& surfaces, bool quantize = false);
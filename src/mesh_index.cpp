@@ -0,0 +1,195 @@
+// mesh_index.cpp
+#include "mesh_index.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+using namespace std;
+
+namespace {
+
+struct VertexKey {
+    uint32_t bits[5];
+    bool operator==(const VertexKey& o) const { return memcmp(bits, o.bits, sizeof(bits)) == 0; }
+};
+
+struct VertexKeyHash {
+    size_t operator()(const VertexKey& k) const {
+        uint64_t h = 1469598103934665603ull;
+        for (uint32_t b : k.bits) h = (h ^ b) * 1099511628211ull;
+        return (size_t)h;
+    }
+};
+
+VertexKey keyOf(const Point5D& p) {
+    float f[5] = {p.x, p.y, p.z, p.u, p.v};
+    VertexKey k;
+    for (int i = 0; i < 5; ++i) {
+        if (f[i] == 0.0f) f[i] = 0.0f; // -0 et +0 soudés ensemble
+        memcpy(&k.bits[i], &f[i], sizeof(float));
+    }
+    return k;
+}
+
+// Paramètres de Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"
+constexpr int CACHE_SIZE = 32;
+constexpr float CACHE_DECAY_POWER = 1.5f;
+constexpr float LAST_TRI_SCORE = 0.75f;
+constexpr float VALENCE_BOOST_SCALE = 2.0f;
+constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+float vertexScore(int cachePos, int remaining) {
+    if (remaining == 0) return -1.0f;
+    float score = 0.0f;
+    if (cachePos >= 0) {
+        if (cachePos < 3) {
+            score = LAST_TRI_SCORE;
+        } else {
+            const float scaler = 1.0f / (CACHE_SIZE - 3);
+            score = pow(1.0f - (cachePos - 3) * scaler, CACHE_DECAY_POWER);
+        }
+    }
+    score += VALENCE_BOOST_SCALE * pow((float)remaining, -VALENCE_BOOST_POWER);
+    return score;
+}
+
+}
+
+void weldSurface(Surfaces& s) {
+    if (!s.indices.empty() || s.points.empty()) return;
+
+    size_t n = s.points.size() - s.points.size() % 3;
+    unordered_map<VertexKey, uint32_t, VertexKeyHash> uniques;
+    uniques.reserve(n);
+    vector<Point5D> points;
+    points.reserve(n);
+    vector<uint32_t> indices;
+    indices.reserve(n);
+
+    for (size_t i = 0; i < n; ++i) {
+        auto [it, inserted] = uniques.emplace(keyOf(s.points[i]), (uint32_t)points.size());
+        if (inserted) points.push_back(s.points[i]);
+        indices.push_back(it->second);
+    }
+
+    points.shrink_to_fit();
+    s.points = std::move(points);
+    s.indices = std::move(indices);
+    ++s.revision;
+}
+
+void optimizeVertexCache(Surfaces& s) {
+    if (s.indices.size() < 3) return;
+
+    const size_t triCount = s.indices.size() / 3;
+    const size_t vertCount = s.points.size();
+    vector<uint32_t>& idx = s.indices;
+    idx.resize(triCount * 3);
+
+    // Triangles adjacents à chaque sommet (CSR)
+    vector<int> remaining(vertCount, 0);
+    for (uint32_t v : idx) remaining[v]++;
+    vector<uint32_t> adjStart(vertCount + 1, 0);
+    for (size_t v = 0; v < vertCount; ++v) adjStart[v + 1] = adjStart[v] + remaining[v];
+    vector<uint32_t> adj(idx.size());
+    vector<uint32_t> fill(adjStart.begin(), adjStart.end() - 1);
+    for (size_t t = 0; t < triCount; ++t)
+        for (int k = 0; k < 3; ++k) adj[fill[idx[t * 3 + k]]++] = (uint32_t)t;
+
+    vector<int> cachePos(vertCount, -1);
+    vector<float> vScore(vertCount);
+    for (size_t v = 0; v < vertCount; ++v) vScore[v] = vertexScore(-1, remaining[v]);
+    vector<float> tScore(triCount);
+    vector<char> emitted(triCount, 0);
+    for (size_t t = 0; t < triCount; ++t)
+        tScore[t] = vScore[idx[t * 3]] + vScore[idx[t * 3 + 1]] + vScore[idx[t * 3 + 2]];
+
+    vector<uint32_t> out;
+    out.reserve(idx.size());
+    vector<uint32_t> cache, nextCache;
+    cache.reserve(CACHE_SIZE + 3);
+    nextCache.reserve(CACHE_SIZE + 3);
+    size_t scanFrom = 0;
+
+    auto bestOverall = [&]() -> long {
+        while (scanFrom < triCount && emitted[scanFrom]) ++scanFrom;
+        long best = -1;
+        float bestScore = -1.0f;
+        for (size_t t = scanFrom; t < triCount; ++t) {
+            if (!emitted[t] && tScore[t] > bestScore) { bestScore = tScore[t]; best = (long)t; }
+        }
+        return best;
+    };
+
+    long best = bestOverall();
+    while (best >= 0) {
+        emitted[best] = 1;
+        const uint32_t* tri = &idx[best * 3];
+        out.insert(out.end(), tri, tri + 3);
+
+        // Le triangle émis passe en tête du cache LRU
+        nextCache.assign(tri, tri + 3);
+        for (uint32_t v : cache)
+            if (v != tri[0] && v != tri[1] && v != tri[2]) nextCache.push_back(v);
+        for (int k = 0; k < 3; ++k) {
+            uint32_t v = tri[k];
+            remaining[v]--;
+            uint32_t* b = &adj[adjStart[v]];
+            uint32_t* e = b + remaining[v] + 1;
+            *std::find(b, e, (uint32_t)best) = *(e - 1); // retire le triangle de la liste d'adjacence
+        }
+        // Les sommets sortis du cache perdent leur bonus, ceux du cache sont repositionnés
+        for (size_t i = CACHE_SIZE; i < nextCache.size(); ++i) cachePos[nextCache[i]] = -1;
+        for (size_t i = 0; i < nextCache.size() && i < (size_t)CACHE_SIZE; ++i) cachePos[nextCache[i]] = (int)i;
+
+        // Mise à jour des scores des sommets touchés et de leurs triangles ; meilleur candidat local
+        best = -1;
+        float bestScore = -1.0f;
+        for (uint32_t v : nextCache) {
+            float ns = vertexScore(cachePos[v], remaining[v]);
+            float delta = ns - vScore[v];
+            vScore[v] = ns;
+            for (int a = 0; a < remaining[v]; ++a) tScore[adj[adjStart[v] + a]] += delta;
+        }
+        if (nextCache.size() > (size_t)CACHE_SIZE) nextCache.resize(CACHE_SIZE);
+        cache.swap(nextCache);
+        for (uint32_t v : cache) {
+            for (int a = 0; a < remaining[v]; ++a) {
+                uint32_t t = adj[adjStart[v] + a];
+                if (tScore[t] > bestScore) { bestScore = tScore[t]; best = t; }
+            }
+        }
+        if (best < 0) best = bestOverall();
+    }
+
+    // Ordre des sommets = ordre de première utilisation (localité des lectures)
+    vector<uint32_t> remap(vertCount, UINT32_MAX);
+    vector<Point5D> points;
+    points.reserve(vertCount);
+    for (uint32_t& v : out) {
+        if (remap[v] == UINT32_MAX) {
+            remap[v] = (uint32_t)points.size();
+            points.push_back(s.points[v]);
+        }
+        v = remap[v];
+    }
+
+    s.points = std::move(points);
+    s.indices = std::move(out);
+    s.lods.clear(); // ils désignaient les sommets dans l'ancien ordre
+    ++s.revision;
+}
+
+void indexSurface(Surfaces& s) {
+    weldSurface(s);
+    optimizeVertexCache(s);
+}
+
+vector<Point5D> expandTriangles(const Surfaces& s) {
+    if (s.indices.empty()) return s.points;
+    vector<Point5D> soup;
+    soup.reserve(s.indices.size());
+    for (uint32_t i : s.indices) soup.push_back(s.points[i]);
+    return soup;
+}
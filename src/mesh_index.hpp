@@ -0,0 +1,17 @@
+// mesh_index.hpp
+#pragma once
+#include "objx.hpp"
+
+// Soude les sommets identiques d'une soupe de triangles (table de hachage sur les 5 composantes).
+// Sans effet si la surface est déjà indexée.
+void weldSurface(Surfaces& s);
+
+// Réordonne les triangles pour le cache post-transformation (algorithme de Forsyth),
+// puis les sommets dans l'ordre de première utilisation.
+void optimizeVertexCache(Surfaces& s);
+
+// weldSurface + optimizeVertexCache, appelé au chargement et à la sauvegarde
+void indexSurface(Surfaces& s);
+
+// Réexpanse les indices en soupe de triangles (format texte, GPU sans index 32 bits)
+std::vector<Point5D> expandTriangles(const Surfaces& s);
@@ -0,0 +1,315 @@
+// mesh_lod.cpp
+#include "mesh_lod.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <queue>
+
+using namespace std;
+
+namespace {
+
+constexpr int DIM = 5; // x, y, z, u, v (UV mises à l'échelle de la surface)
+constexpr float LEVEL_MIN_GAIN = 0.9f;
+
+using Vec5 = array<double, DIM>;
+
+double dot(const Vec5& a, const Vec5& b) {
+    double d = 0;
+    for (int i = 0; i < DIM; ++i) d += a[i] * b[i];
+    return d;
+}
+
+// Erreur vᵀAv + 2bᵀv + c : carré de la distance aux plans (en 5D) des triangles d'origine,
+// pondéré par leur aire ; divisé par l'aire totale, c'est un écart moyen comparable à maxError
+struct Quadric {
+    double a[DIM][DIM] = {};
+    Vec5 b = {};
+    double c = 0;
+    double aire = 0;
+
+    Quadric& operator+=(const Quadric& o) {
+        for (int i = 0; i < DIM; ++i) {
+            for (int j = 0; j < DIM; ++j) a[i][j] += o.a[i][j];
+            b[i] += o.b[i];
+        }
+        c += o.c;
+        aire += o.aire;
+        return *this;
+    }
+
+    double eval(const Vec5& v) const {
+        double e = c;
+        for (int i = 0; i < DIM; ++i) {
+            double row = 0;
+            for (int j = 0; j < DIM; ++j) row += a[i][j] * v[j];
+            e += v[i] * row + 2 * b[i] * v[i];
+        }
+        return e;
+    }
+};
+
+// Garland-Heckbert 1998 : base orthonormée (e1, e2) du plan du triangle, pondérée par son aire
+bool triangleQuadric(const Vec5& p, const Vec5& q, const Vec5& r, Quadric& out) {
+    Vec5 e1, e2;
+    for (int i = 0; i < DIM; ++i) {
+        e1[i] = q[i] - p[i];
+        e2[i] = r[i] - p[i];
+    }
+    double l1 = sqrt(dot(e1, e1));
+    if (l1 == 0) return false;
+    for (double& x : e1) x /= l1;
+    double proj = dot(e2, e1);
+    for (int i = 0; i < DIM; ++i) e2[i] -= proj * e1[i];
+    double l2 = sqrt(dot(e2, e2));
+    if (l2 < 1e-12 * l1) return false;
+    for (double& x : e2) x /= l2;
+
+    double aire = 0.5 * l1 * l2;
+    double p1 = dot(p, e1), p2 = dot(p, e2);
+    for (int i = 0; i < DIM; ++i) {
+        for (int j = 0; j < DIM; ++j) out.a[i][j] = aire * ((i == j) - e1[i] * e1[j] - e2[i] * e2[j]);
+        out.b[i] = aire * (p1 * e1[i] + p2 * e2[i] - p[i]);
+    }
+    out.c = aire * (dot(p, p) - p1 * p1 - p2 * p2);
+    out.aire = aire;
+    return true;
+}
+
+struct Collapse {
+    double cost;
+    float length; // à coût égal (zones planes), l'arête la plus courte d'abord : réduction uniforme
+    uint32_t from, to;
+    unsigned fromVersion, toVersion;
+    bool operator>(const Collapse& o) const { return cost != o.cost ? cost > o.cost : length > o.length; }
+};
+
+class Simplifier {
+public:
+    explicit Simplifier(const Surfaces& s) : points(s.points) {
+        const size_t n = points.size();
+        Aabb box;
+        for (const auto& p : points) box.extend(p);
+        float d[3] = {box.max[0] - box.min[0], box.max[1] - box.min[1], box.max[2] - box.min[2]};
+        diagonal = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        uvScale = diagonal > 0 ? diagonal : 1.0;
+        bruit = 1e-10 * uvScale * uvScale;
+
+        tris.resize(s.indices.size() / 3);
+        for (size_t t = 0; t < tris.size(); ++t) {
+            tris[t] = {s.indices[t * 3], s.indices[t * 3 + 1], s.indices[t * 3 + 2]};
+        }
+        alive.assign(tris.size(), 1);
+        aliveCount = tris.size();
+        vertexTris.resize(n);
+        for (size_t t = 0; t < tris.size(); ++t) {
+            for (uint32_t v : tris[t]) vertexTris[v].push_back((uint32_t)t);
+        }
+
+        // Arêtes de bord (un seul triangle) ou non manifold : leurs sommets restent en place
+        map<pair<uint32_t, uint32_t>, int> edges;
+        for (const auto& t : tris) {
+            for (int k = 0; k < 3; ++k) {
+                uint32_t a = t[k], b = t[(k + 1) % 3];
+                ++edges[{min(a, b), max(a, b)}];
+            }
+        }
+        locked.assign(n, 0);
+        for (const auto& [e, count] : edges) {
+            if (count != 2) locked[e.first] = locked[e.second] = 1;
+        }
+
+        quadrics.resize(n);
+        for (const auto& t : tris) {
+            Quadric q;
+            if (!triangleQuadric(vec(t[0]), vec(t[1]), vec(t[2]), q)) continue;
+            for (uint32_t v : t) quadrics[v] += q;
+        }
+        version.assign(n, 0);
+        for (const auto& [e, count] : edges) {
+            if (count != 2) continue;
+            push(e.first, e.second);
+            push(e.second, e.first);
+        }
+    }
+
+    double size() const { return diagonal; }
+    size_t triangles() const { return aliveCount; }
+
+    // Effondre les arêtes les moins coûteuses jusqu'à target triangles, sans dépasser l'écart maxError
+    void reduce(size_t target, double maxError) {
+        const double limite = maxError * maxError;
+        vector<uint32_t> voisins;
+        while (aliveCount > target && !heap.empty()) {
+            Collapse c = heap.top();
+            if (!current(c)) {
+                heap.pop();
+                continue;
+            }
+            if (c.cost > limite) break; // gardé pour le niveau suivant, plus tolérant
+            heap.pop();
+            if (!canCollapse(c.from, c.to)) continue; // réessayé si le voisinage change
+            apply(c.from, c.to);
+
+            neighbours(c.to, voisins);
+            for (uint32_t w : voisins) {
+                push(w, c.to);
+                push(c.to, w);
+            }
+        }
+    }
+
+    vector<uint32_t> indices() const {
+        vector<uint32_t> out;
+        out.reserve(aliveCount * 3);
+        for (size_t t = 0; t < tris.size(); ++t) {
+            if (alive[t]) out.insert(out.end(), tris[t].begin(), tris[t].end());
+        }
+        return out;
+    }
+
+private:
+    Vec5 vec(uint32_t i) const {
+        const Point5D& p = points[i];
+        return {p.x, p.y, p.z, p.u * uvScale, p.v * uvScale};
+    }
+
+    bool current(const Collapse& c) const {
+        return version[c.from] == c.fromVersion && version[c.to] == c.toVersion;
+    }
+
+    void push(uint32_t from, uint32_t to) {
+        if (locked[from]) return;
+        Quadric q = quadrics[from];
+        q += quadrics[to];
+        double cost = q.aire > 0 ? q.eval(vec(to)) / q.aire : 0.0;
+        if (cost < bruit) cost = 0; // erreurs d'arrondi d'une zone plane : départagées par la longueur
+        const Point5D &a = points[from], &b = points[to];
+        float dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+        heap.push({cost, dx * dx + dy * dy + dz * dz, from, to, version[from], version[to]});
+    }
+
+    void neighbours(uint32_t v, vector<uint32_t>& out) const {
+        out.clear();
+        for (uint32_t t : vertexTris[v]) {
+            for (uint32_t w : tris[t]) {
+                if (w != v) out.push_back(w);
+            }
+        }
+        sort(out.begin(), out.end());
+        out.erase(unique(out.begin(), out.end()), out.end());
+    }
+
+    bool canCollapse(uint32_t from, uint32_t to) {
+        // Condition de lien : les voisins communs sont exactement les sommets opposés à l'arête,
+        // sinon l'effondrement recollerait deux morceaux de surface (arête non manifold)
+        neighbours(from, voisinsFrom);
+        neighbours(to, voisinsTo);
+        size_t communs = 0, partages = 0;
+        for (size_t i = 0, j = 0; i < voisinsFrom.size() && j < voisinsTo.size();) {
+            if (voisinsFrom[i] < voisinsTo[j]) ++i;
+            else if (voisinsFrom[i] > voisinsTo[j]) ++j;
+            else { ++communs; ++i; ++j; }
+        }
+        for (uint32_t t : vertexTris[from]) {
+            const auto& tri = tris[t];
+            if (tri[0] == to || tri[1] == to || tri[2] == to) ++partages;
+        }
+        if (partages != 2 || communs != 2) return false;
+
+        // Aucun triangle restant ne doit se retourner, ni dans l'espace ni dans la texture
+        const Point5D& cible = points[to];
+        for (uint32_t t : vertexTris[from]) {
+            const auto& tri = tris[t];
+            if (tri[0] == to || tri[1] == to || tri[2] == to) continue;
+            Point5D avant[3], apres[3];
+            for (int k = 0; k < 3; ++k) {
+                avant[k] = points[tri[k]];
+                apres[k] = tri[k] == from ? cible : avant[k];
+            }
+            float n0[3], n1[3];
+            normal(avant, n0);
+            normal(apres, n1);
+            float d = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2];
+            float l1 = n1[0] * n1[0] + n1[1] * n1[1] + n1[2] * n1[2];
+            if (d <= 0 || l1 == 0) return false;
+            float uv0 = uvArea(avant), uv1 = uvArea(apres);
+            if (uv0 != 0 && (uv1 == 0 || (uv0 > 0) != (uv1 > 0))) return false;
+        }
+        return true;
+    }
+
+    static void normal(const Point5D (&p)[3], float n[3]) {
+        float ax = p[1].x - p[0].x, ay = p[1].y - p[0].y, az = p[1].z - p[0].z;
+        float bx = p[2].x - p[0].x, by = p[2].y - p[0].y, bz = p[2].z - p[0].z;
+        n[0] = ay * bz - az * by;
+        n[1] = az * bx - ax * bz;
+        n[2] = ax * by - ay * bx;
+    }
+
+    static float uvArea(const Point5D (&p)[3]) {
+        return (p[1].u - p[0].u) * (p[2].v - p[0].v) - (p[2].u - p[0].u) * (p[1].v - p[0].v);
+    }
+
+    void apply(uint32_t from, uint32_t to) {
+        for (uint32_t t : vertexTris[from]) {
+            auto& tri = tris[t];
+            if (tri[0] == to || tri[1] == to || tri[2] == to) {
+                alive[t] = 0;
+                --aliveCount;
+                for (uint32_t w : tri) {
+                    if (w == from) continue;
+                    auto& liste = vertexTris[w];
+                    liste.erase(std::find(liste.begin(), liste.end(), t));
+                }
+            } else {
+                for (uint32_t& w : tri) {
+                    if (w == from) w = to;
+                }
+                vertexTris[to].push_back(t);
+            }
+        }
+        vertexTris[from].clear();
+        quadrics[to] += quadrics[from];
+        ++version[from];
+        ++version[to];
+    }
+
+    const std::vector<Point5D>& points;
+    double diagonal = 0, uvScale = 1, bruit = 0;
+    vector<array<uint32_t, 3>> tris;
+    vector<char> alive;
+    size_t aliveCount = 0;
+    vector<vector<uint32_t>> vertexTris;
+    vector<char> locked;
+    vector<Quadric> quadrics;
+    vector<unsigned> version;
+    priority_queue<Collapse, vector<Collapse>, greater<Collapse>> heap;
+    vector<uint32_t> voisinsFrom, voisinsTo;
+};
+
+}
+
+void buildLods(Surfaces& s, const LodOptions& options) {
+    s.lods.clear();
+    if (s.indices.size() < 3 || s.indices.size() / 3 < options.minTriangles) return;
+
+    Simplifier simplifier(s);
+    double erreur = options.maxError * simplifier.size();
+    size_t precedent = simplifier.triangles();
+    for (size_t level = 1; level <= options.maxLevels; ++level, erreur *= 2) {
+        size_t cible = (size_t)(precedent * options.ratio);
+        simplifier.reduce(cible, erreur);
+        size_t n = simplifier.triangles();
+        if (n == 0 || n > precedent * LEVEL_MIN_GAIN) break;
+        s.lods.push_back(simplifier.indices());
+        precedent = n;
+        if (n < options.minTriangles) break;
+    }
+}
+
+const vector<uint32_t>& lodIndices(const Surfaces& s, size_t level) {
+    if (level == 0 || s.lods.empty()) return s.indices;
+    return s.lods[min(level, s.lods.size()) - 1];
+}
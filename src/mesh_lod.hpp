@@ -0,0 +1,22 @@
+// mesh_lod.hpp
+#pragma once
+#include "objx.hpp"
+
+// Niveaux de détail d'une surface indexée, par effondrement d'arêtes (quadriques d'erreur de
+// Garland-Heckbert, étendues aux UV) : un sommet rejoint un voisin existant, donc tous les niveaux
+// partagent les points du niveau 0 et seuls les indices changent.
+// Les sommets de bord ne bougent jamais : contour de la surface, mais aussi coutures UV, puisque
+// deux sommets de même position et d'UV différentes ne sont pas soudés (mesh_index.hpp).
+struct LodOptions {
+    size_t maxLevels = 3;     // niveaux en plus du maillage complet
+    float ratio = 0.5f;       // part des triangles visée d'un niveau au suivant
+    float maxError = 0.005f;  // écart toléré au niveau 1, en fraction de la diagonale de la surface ; doublé à chaque niveau
+    size_t minTriangles = 16; // en dessous, pas de niveau plus grossier
+};
+
+// Remplit s.lods (vidé d'abord) ; sans effet sur une soupe de triangles.
+// Un niveau qui n'enlève pas au moins un dixième des triangles du précédent n'est pas gardé.
+void buildLods(Surfaces& s, const LodOptions& options = LodOptions());
+
+// Indices du niveau demandé (0 = complet), le plus grossier disponible au-delà
+const std::vector<uint32_t>& lodIndices(const Surfaces& s, size_t level);
@@ -0,0 +1,120 @@
+// mesh_text.cpp
+#include "mesh_text.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <thread>
+
+using namespace std;
+
+static const size_t TEXT_CHUNK_MIN = 4 * 1024 * 1024; // en dessous, un seul thread
+
+// Threads de lecture en plus de l'appelant, pour tout le processus : plusieurs archives ouvertes en même
+// temps sur le pool se partagent les cœurs au lieu d'en lancer chacune autant qu'il y en a
+static atomic<int> threadsLibres{max(1, (int)thread::hardware_concurrency()) - 1};
+
+static int reserveThreads(int voulus) {
+    int libres = threadsLibres.load();
+    int pris;
+    do {
+        pris = min(voulus, libres);
+        if (pris <= 0) return 0;
+    } while (!threadsLibres.compare_exchange_weak(libres, libres - pris));
+    return pris;
+}
+
+// Fin de la ligne qui commence en p : le '\n' (trouvé par memchr, vectorisé par la libc), sinon fin
+static const char* endOfLine(const char* p, const char* fin) {
+    const char* nl = static_cast<const char*>(memchr(p, '\n', fin - p));
+    return nl ? nl : fin;
+}
+
+// Lignes "v" de la surface qui commence en p, jusqu'à la prochaine ligne vide : réservées d'un coup
+static size_t countVertices(const char* p, const char* fin) {
+    size_t n = 0;
+    while (p < fin && *p != '\n') {
+        n += *p == 'v';
+        p = endOfLine(p, fin) + 1;
+    }
+    return n;
+}
+
+// Comme istringstream >> float : blancs sautés, '+' accepté ; valeur manquante ou illisible = 0
+static Point5D parseVertex(const char* p, const char* fin) {
+    float f[5] = {};
+    for (float& x : f) {
+        while (p < fin && isspace((unsigned char)*p)) ++p;
+        if (p < fin && *p == '+') ++p;
+        auto [suite, ec] = from_chars(p, fin, x);
+        if (ec != errc()) break;
+        p = suite;
+    }
+    return {f[0], f[1], f[2], f[3], f[4]};
+}
+
+static void parseChunk(const char* debut, const char* fin, vector<Surfaces>& out) {
+    Surfaces* surf = nullptr; // surface en cours, créée à sa première ligne
+    for (const char* p = debut; p < fin;) {
+        const char* eol = endOfLine(p, fin);
+        if (eol == p) { // ligne vide : la surface en cours est close
+            if (surf && surf->points.empty()) out.pop_back();
+            surf = nullptr;
+        } else {
+            if (!surf) {
+                surf = &out.emplace_back();
+                surf->points.reserve(countVertices(p, fin));
+            }
+            if (eol - p >= 8 && memcmp(p, "texture=", 8) == 0) {
+                surf->texture.assign(p + 8, eol);
+            } else if (*p == 'v') {
+                surf->points.push_back(parseVertex(p + min<ptrdiff_t>(2, eol - p), eol));
+            }
+        }
+        p = eol + 1;
+    }
+    if (surf && surf->points.empty()) out.pop_back();
+}
+
+void readMeshText(const unsigned char* data, size_t size, vector<Surfaces>& out) {
+    const char* texte = reinterpret_cast<const char*>(data);
+    const char* fin = texte + size;
+
+    size_t voulus = max<size_t>(1, min<size_t>(thread::hardware_concurrency(), size / TEXT_CHUNK_MIN));
+    int reserves = reserveThreads((int)voulus - 1);
+    size_t morceaux = 1 + reserves;
+
+    // Coupes juste après une ligne vide : chaque morceau commence sur une surface neuve
+    vector<const char*> bornes = {texte};
+    for (size_t k = 1; k < morceaux; ++k) {
+        const char* p = max(bornes.back(), texte + size * k / morceaux);
+        while (p < fin) {
+            const char* eol = endOfLine(p, fin);
+            if (eol + 1 < fin && eol[1] == '\n') {
+                p = eol + 2;
+                break;
+            }
+            p = eol + 1;
+        }
+        if (p >= fin) break;
+        bornes.push_back(p);
+    }
+    bornes.push_back(fin);
+
+    vector<vector<Surfaces>> lues(bornes.size() - 1);
+    vector<thread> threads;
+    for (size_t k = 1; k < lues.size(); ++k) {
+        threads.emplace_back([&, k]() { parseChunk(bornes[k], bornes[k + 1], lues[k]); });
+    }
+    parseChunk(bornes[0], bornes[1], lues[0]);
+    for (auto& t : threads) t.join();
+    threadsLibres += reserves; // y compris ceux non lancés (coupe introuvable)
+
+    size_t total = out.size();
+    for (const auto& l : lues) total += l.size();
+    out.reserve(total);
+    for (auto& l : lues) {
+        for (auto& s : l) out.push_back(std::move(s));
+    }
+}
@@ -0,0 +1,14 @@
+// mesh_text.hpp
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "objx.hpp"
+
+// Format texte du mesh (entrée "map.mesh", anciennes archives) : une surface par bloc de lignes,
+// blocs séparés par une ligne vide ; "texture=<nom>" puis une ligne "v x y z u v" par coin.
+// Une surface sans sommet est ignorée.
+
+// Ajoute à out les surfaces lues ; résultat identique à l'ancienne lecture par getline/istringstream
+// pour toute ligne bien formée. Au-delà de quelques Mo, le texte est découpé aux lignes vides
+// et les morceaux lus en parallèle.
+void readMeshText(const unsigned char* data, size_t size, std::vector<Surfaces>& out);
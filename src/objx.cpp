@@ -1,95 +1,127 @@
 // Objx.cpp
 #include "objx.hpp"
+#include "mesh_binary.hpp"
+#include "mesh_index.hpp"
+#include "mesh_lod.hpp"
+#include "mesh_text.hpp"
+#include "etc1.hpp"
 #include "file_dialog.hpp"
+#include "profiler.hpp"
+#include <cstring>
 #include <filesystem>
-#include <zip.h>
 #include <iostream>
-#include <fstream>
 #include <set>
+#include <sstream>
 
 using namespace std;
 namespace fs = std::filesystem;
 
+static const size_t MESH_DATA_ALIGN = 16;   // profil aligné : floats du meshb lisibles sur place
+static const size_t TEXTURE_PAGE_ALIGN = 4096; // profil aligné : textures pré-décodées, une page par début
+
 Objx::Objx() {
     surfaces.emplace_back();
 }
-Objx Objx::open(const std::string& path) {
+
+void Aabb::extend(const Point5D& p) {
+    const float c[3] = {p.x, p.y, p.z};
+    for (int i = 0; i < 3; ++i) {
+        if (c[i] < min[i]) min[i] = c[i];
+        if (c[i] > max[i]) max[i] = c[i];
+    }
+}
+
+void Aabb::extend(const Aabb& b) {
+    for (int i = 0; i < 3; ++i) {
+        if (b.min[i] < min[i]) min[i] = b.min[i];
+        if (b.max[i] > max[i]) max[i] = b.max[i];
+    }
+}
+
+static bool endsWith(const string& s, const string& suffix) {
+    return s.size() > suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static string meshVersTexte(const vector<Surfaces>& surfaces) {
+    ostringstream out;
+    for (const auto& s : surfaces) {
+        out << "texture=" << fs::path(s.texture).filename().string() << "\n";
+        for (size_t i = 0; i < s.cornerCount(); ++i) {
+            const Point5D& p = s.corner(i);
+            out << "v " << p.x << " " << p.y << " " << p.z << " " << p.u << " " << p.v << "\n";
+        }
+        out << "\n";
+    }
+    return out.str();
+}
+Objx Objx::open(const std::string& path, ArchiveAccess access) {
+    PROFILE_SCOPE_DETAIL("Objx::open", path);
     cout << "[importation] " << path << "\n";
 
     // Créer l'objet Objx à remplir
     Objx px;
 
-    // Extraction
-    int err = 0;
-    zip_t* archive = zip_open(path.c_str(), 0, &err);
-    if (!archive) {
-        cerr << "Erreur ouverture .Objx: code=" << err << endl;
+    // Lecture en mémoire, sans dossier d'extraction
+    map<string, Blob> entries;
+    if (!readArchive(path, entries, access)) {
+        cerr << "Erreur ouverture .Objx : " << path << endl;
         return px; // retourne un objet vide
     }
     cout << "[importation] archive ouverte\n";
 
-    string extractDir = "assets/temp_extract";
-    fs::create_directories(extractDir);
-    zip_int64_t num_files = zip_get_num_entries(archive, 0);
-    cout << "[importation] dossier d'extraction créé\n";
-
     cout << "[importation] l'Archive contient :\n";
-    string meshFile;
-    for (int i = 0; i < num_files; ++i) {
-        const char* name = zip_get_name(archive, i, 0);
-        cout << "[importation]\t" << name << "\n";
-        zip_file_t* zf = zip_fopen_index(archive, i, 0);
-        if (!zf) continue;
-
-        string outPath = extractDir + "/" + name;
-        ofstream outFile(outPath, ios::binary);
-
-        char buffer[4096];
-        zip_int64_t bytesRead;
-        while ((bytesRead = zip_fread(zf, buffer, sizeof(buffer))) > 0) {
-            outFile.write(buffer, bytesRead);
-        }
-        zip_fclose(zf);
+    string meshFile, meshBinFile;
+    for (const auto& [name, blob] : entries) {
+        cout << "[importation]\t" << name << " (" << blob.size << " octets)\n";
+        if (endsWith(name, ".mesh")) meshFile = name;
+        if (endsWith(name, ".meshb")) meshBinFile = name;
+    }
 
-        if (string(name).size() > 5 && string(name).substr(string(name).size() - 5) == ".mesh") {
-            meshFile = outPath;
+    // Le format binaire est préféré ; le .mesh texte reste lu pour les anciennes archives
+    if (!meshBinFile.empty()) {
+        const Blob& mesh = entries[meshBinFile];
+        vector<Surfaces> lues;
+        if (readMeshBinary(mesh.data, mesh.size, lues)) {
+            for (auto& surf : lues) px.surfaces.push_back(std::move(surf));
+            meshFile = meshBinFile;
+        } else {
+            cerr << "[importation] " << meshBinFile << " illisible, repli sur le format texte" << endl;
         }
     }
-
-    zip_close(archive);
-
-    // Lire le fichier .mesh
     if (meshFile.empty()) {
         cerr << "Aucun fichier .mesh trouvé dans l’archive." << endl;
         return px;
     }
-
-    ifstream in(meshFile);
-    if (!in.is_open()) {
-        cerr << "Échec d'ouverture de " << meshFile << endl;
-        return px;
+    if (meshFile != meshBinFile) {
+        const Blob& mesh = entries[meshFile];
+        size_t avant = px.surfaces.size();
+        readMeshText(mesh.data, mesh.size, px.surfaces);
+        for (size_t i = avant; i < px.surfaces.size(); ++i) {
+            cout << "[importation] texture trouvée : " << px.surfaces[i].texture << "\n";
+        }
     }
 
-    string line;
-    Surfaces surf;
-    while (getline(in, line)) {
-        if (line.empty()) {
-            if (!surf.points.empty()) px.addSurface(surf);
-            surf = Surfaces();
-            continue;
-        }
-        if (line.rfind("texture=", 0) == 0) {
-            cout << "[importation] texture trouvée : " << line;
-            surf.texture = line.substr(8);
-        } else if (line[0] == 'v') {
-            istringstream ss(line.substr(2));
-            float x, y, z, u, v;
-            ss >> x >> y >> z >> u >> v;
-            surf.points.push_back({x, y, z, u, v});
-        }
+    // Les soupes de triangles (texte, meshb v1) sont soudées et réordonnées une fois ici
+    for (auto& s : px.surfaces) {
+        if (!s.indices.empty()) continue;
+        size_t avant = s.points.size();
+        indexSurface(s);
+        cout << "[importation] " << avant << " sommets soudés en " << s.points.size() << "\n";
+    }
+    // Archives d'avant les niveaux de détail (texte, meshb v1/v2) : calculés ici, hors du thread de rendu
+    size_t niveaux = 0;
+    for (auto& s : px.surfaces) {
+        if (!s.lods.empty()) continue;
+        buildLods(s);
+        niveaux += s.lods.size();
     }
-    if (!surf.points.empty()) px.addSurface(surf);
+    if (niveaux) cout << "[importation] " << niveaux << " niveau(x) de détail calculé(s)\n";
 
+    // Le reste de l'archive (textures) reste en mémoire pour loadTexture
+    entries.erase(meshFile);
+    entries.erase(meshBinFile);
+    px.embedded = std::move(entries);
+    px.updateBounds();
     px.setEmplacement(path); 
     return px;
 }
@@ -102,6 +134,32 @@ std::vector<Surfaces>& Objx::getSurfaces() {
     return surfaces;
 }
 
+const std::vector<Surfaces>& Objx::getSurfaces() const {
+    return surfaces;
+}
+
+const Blob* Objx::getEmbedded(const string& name) const {
+    auto it = embedded.find(name);
+    return it == embedded.end() ? nullptr : &it->second;
+}
+
+void Objx::embed(const string& name, const Blob& data) {
+    embedded[name] = data;
+}
+
+void Objx::updateBounds() {
+    bounds = Aabb();
+    for (auto& s : surfaces) {
+        s.bounds = Aabb();
+        for (const auto& p : s.points) s.bounds.extend(p);
+        if (!s.bounds.empty()) bounds.extend(s.bounds);
+    }
+}
+
+const Aabb& Objx::getBounds() const {
+    return bounds;
+}
+
 string Objx::getEmplacement() const {
     return emplacement;
 }
@@ -109,67 +167,102 @@ void Objx::setEmplacement(string path) {
     emplacement = path;
 }
 
-bool Objx::save() {
+// Encode la texture en ETC1 (taille puissance de 2, mipmaps), pour l'entrée à côté du PNG
+static Blob packEtc1(const Blob& png, const string& name) {
+    ImageRGBA img;
+    if (!decodeImage(png, img)) return Blob();
+    Etc1Texture tex = encodeEtc1(buildMipChain(resizeToPowerOfTwo(img)));
+    vector<unsigned char> bytes = writeEtc1Container(tex);
+    cout << "[Objx save] ETC1 " << name << " : " << bytes.size() << " octets"
+         << (tex.hasAlpha ? " (avec plan alpha)" : "") << "\n";
+    return Blob::fromVector(std::move(bytes));
+}
+
+// Chaîne de mipmaps RGBA prête à envoyer, pour le profil aligné
+static Blob packRaw(const Blob& png, const string& name) {
+    ImageRGBA img;
+    if (!decodeImage(png, img)) return Blob();
+    vector<unsigned char> bytes = writeRawTexture(buildMipChain(resizeToPowerOfTwo(img)));
+    cout << "[Objx save] pré-décodée " << name << " : " << bytes.size() << " octets\n";
+    return Blob::fromVector(std::move(bytes));
+}
+
+bool Objx::save(const SaveOptions& options) {
+    PROFILE_SCOPE("Objx::save");
     if (emplacement == "") {
 		emplacement = ouvrirBoiteFichier(true);  // ou une variante de boîte de sauvegarde
 		if (emplacement == "") return false; // utilisateur a annulé
 	}
 	cout << "[Objx save] emplacement : " << emplacement;
 
-    string tempFolder = "assets/export_temp/";
-    fs::create_directories(tempFolder);
-
-    set<string> copied;
+    // Tout est assemblé en mémoire : pas de dossier temporaire, les PNG sont stockés sans recompression
+    vector<ArchiveEntry> sortie;
+    set<string> noms;
     for (const auto& s : surfaces) {
+        if (s.texture.empty()) continue;
         fs::path texPath = s.texture;
         string filename = texPath.filename().string();
-        string dest = tempFolder + filename;
+        if (!noms.insert(filename).second) continue;
 
-        // 💡 Copier seulement si le chemin est absolu ou contient un sous-dossier
+        // Chemin absolu ou avec sous-dossier : texture externe, sinon entrée déjà embarquée
         bool textureExterne = texPath.is_absolute() || texPath.parent_path() != "";
-
-        if (textureExterne && copied.count(filename) == 0) {
-            copied.insert(filename);
-            try {
-                fs::copy_file(texPath, dest, fs::copy_options::overwrite_existing);
-            } catch (const std::exception& ex) {
-                cerr << "Erreur lors de la copie de la texture : " << ex.what() << endl;
-                return false;
-            }
+        const Blob* embarque = getEmbedded(filename);
+        Blob png = textureExterne ? Blob::fromFile(texPath.string()) : (embarque ? *embarque : Blob());
+        if (png.empty()) {
+            cerr << "Erreur lors de la lecture de la texture : " << s.texture << endl;
+            return false;
         }
-    }
-
-    // 🔁 Écriture du fichier .mesh
-    string meshPath = tempFolder + "map.mesh";
-    ofstream out(meshPath);
-    for (const auto& s : surfaces) {
-        out << "texture=" << fs::path(s.texture).filename().string() << "\n";
-        for (const auto& p : s.points) {
-            out << "v " << p.x << " " << p.y << " " << p.z << " " << p.u << " " << p.v << "\n";
+        sortie.push_back({filename, png, false});
+
+        // Un ETC1 ou une version pré-décodée déjà embarqués restent valables tant que le PNG n'a pas changé
+        bool pngInchange = embarque && embarque->size == png.size
+                        && (embarque->data == png.data || memcmp(embarque->data, png.data, png.size) == 0);
+        string nomEtc1 = etc1EntryName(filename);
+        const Blob* etc1 = getEmbedded(nomEtc1);
+        if (etc1 && pngInchange) {
+            sortie.push_back({nomEtc1, *etc1, false});
+        } else if (options.etc1) {
+            Blob packed = packEtc1(png, nomEtc1);
+            if (packed.empty()) cerr << "[Objx save] ETC1 impossible pour " << filename << endl;
+            else sortie.push_back({nomEtc1, packed, false});
+        }
+        if (options.aligned) {
+            string nomRaw = rawTextureEntryName(filename);
+            const Blob* raw = getEmbedded(nomRaw);
+            Blob packed = raw && pngInchange ? *raw : packRaw(png, nomRaw);
+            if (packed.empty()) cerr << "[Objx save] pré-décodage impossible pour " << filename << endl;
+            else sortie.push_back({nomRaw, packed, false, TEXTURE_PAGE_ALIGN});
         }
-        out << "\n";
     }
 
-    // 📦 Création du zip
-    string zipPath;
-    if (zipPath.size() < 5 || zipPath.substr(-5) != ".objx") {
-        zipPath = emplacement + ".objx";
+    // 🔁 Entrée mesh, écrite directement depuis la mémoire
+    for (auto& s : surfaces) {
+        indexSurface(s);
+        buildLods(s); // l'ordre des sommets vient de changer
     }
-    int err = 0;
-    zip_t* archive = zip_open(zipPath.c_str(), ZIP_CREATE | ZIP_TRUNCATE, &err);
-    if (!archive) return false;
-
-    for (const auto& entry : fs::directory_iterator(tempFolder)) {
-        string filePath = entry.path().string();
-        string fileName = entry.path().filename().string();
-        zip_source_t* source = zip_source_file(archive, filePath.c_str(), 0, 0);
-        if (!source || zip_file_add(archive, fileName.c_str(), source, ZIP_FL_OVERWRITE) < 0) {
-            if (source) zip_source_free(source);
-        }
+    if (options.mesh == MeshFormat::Binary) {
+        sortie.push_back({"map.meshb", Blob::fromVector(writeMeshBinary(surfaces, options.quantize)), !options.aligned, MESH_DATA_ALIGN});
+    } else {
+        string texte = meshVersTexte(surfaces);
+        sortie.push_back({"map.mesh", Blob::fromVector(vector<unsigned char>(texte.begin(), texte.end())), !options.aligned});
     }
 
-    zip_close(archive);
-    fs::remove_all(tempFolder);
+    // 📦 Une archive existante est mise à jour : seules les entrées modifiées sont réécrites
+    string zipPath = emplacement;
+    if (!endsWith(zipPath, ".objx") && !endsWith(zipPath, ".plxl")) zipPath += ".objx";
+    ArchiveWriteStats stats;
+    bool ok = options.aligned ? writeAlignedArchive(zipPath, sortie, &stats) : writeArchive(zipPath, sortie, &stats);
+    if (!ok) return false;
+    cout << "\n[Objx save] " << stats.written << " entrée(s) écrite(s) (" << stats.bytesWritten << " octets), "
+         << stats.unchanged << " inchangée(s), " << stats.removed << " supprimée(s)\n";
+
+    // Les textures font désormais partie de l'archive : les sauvegardes suivantes n'ont plus à les relire
+    for (const auto& e : sortie) {
+        if (!endsWith(e.name, ".mesh") && !endsWith(e.name, ".meshb")) embedded[e.name] = e.data;
+    }
+    for (auto& s : surfaces) {
+        if (!s.texture.empty()) s.texture = fs::path(s.texture).filename().string();
+    }
     emplacement = zipPath;
     return true;
 }
@@ -180,37 +273,25 @@ string Objx::toString() {
         return "";
     }
 
-    int err = 0;
-    zip_t* archive = zip_open(emplacement.c_str(), 0, &err);
-    if (!archive) {
-        cerr << "[inspecter] Erreur ouverture archive: code=" << err << endl;
+    map<string, Blob> entries;
+    if (!readArchive(emplacement, entries)) {
+        cerr << "[inspecter] Erreur ouverture archive " << emplacement << endl;
         return "";
     }
 
-    zip_int64_t num_files = zip_get_num_entries(archive, 0);
-    for (int i = 0; i < num_files; ++i) {
-        const char* name = zip_get_name(archive, i, 0);
-        if (!name) continue;
-
-        string filename = name;
-        if (filename.size() < 5 || filename.substr(-5) == ".mesh") continue;
-
-        zip_file_t* zf = zip_fopen_index(archive, i, 0);
-        if (!zf) continue;
-
-        stringstream ss;
-        char buffer[4096];
-        zip_int64_t bytesRead;
-        while ((bytesRead = zip_fread(zf, buffer, sizeof(buffer))) > 0) {
-            ss.write(buffer, bytesRead);
+    // Le .meshb est rendu dans la syntaxe texte pour rester lisible
+    for (const auto& [name, blob] : entries) {
+        if (endsWith(name, ".meshb")) {
+            vector<Surfaces> lues;
+            if (readMeshBinary(blob.data, blob.size, lues)) return meshVersTexte(lues);
+        }
+    }
+    for (const auto& [name, blob] : entries) {
+        if (endsWith(name, ".mesh")) {
+            return string(reinterpret_cast<const char*>(blob.data), blob.size); // 🟢 premier .mesh trouvé
         }
-        zip_fclose(zf);
-        zip_close(archive);
-
-        return ss.str(); // 🟢 Retourne immédiatement dès que le .mesh est trouvé
     }
 
-    zip_close(archive);
     cerr << "[inspecter] Aucun fichier .mesh trouvé." << endl;
     return "";
 }
@@ -3,6 +3,9 @@
 #include <string>
 #include <vector>
 #include <optional>
+#include <cstdint>
+#include <map>
+#include "archive.hpp"
 
 using namespace std; 
 
@@ -11,27 +14,68 @@ struct Point5D {
     float u, v;
 };
 
+// Boîte englobante alignée sur les axes ; vide tant que min > max
+struct Aabb {
+    float min[3] = {1e30f, 1e30f, 1e30f};
+    float max[3] = {-1e30f, -1e30f, -1e30f};
+
+    bool empty() const { return min[0] > max[0]; }
+    void extend(const Point5D& p);
+    void extend(const Aabb& b);
+};
+
 struct Surfaces {
     std::vector<Point5D> points;
+    std::vector<uint32_t> indices; // triangles (3 indices chacun) ; vide = points est une soupe de triangles
+    std::vector<std::vector<uint32_t>> lods; // niveaux plus grossiers sur les mêmes points (mesh_lod.hpp)
     std::string texture; // Peut être un chemin complet tant que non sauvegardé
+    unsigned revision = 0; // à incrémenter à chaque modification de points ou indices (invalide le VBO)
+    Aabb bounds;           // mise à jour par Objx::updateBounds()
+
+    size_t cornerCount() const { return indices.empty() ? points.size() : indices.size(); }
+    const Point5D& corner(size_t i) const { return indices.empty() ? points[i] : points[indices[i]]; }
+};
+
+// Format de l'entrée mesh écrite par save() ; open() lit les deux
+enum class MeshFormat {
+    Text,   // map.mesh, lignes "v x y z u v"
+    Binary  // map.meshb, voir mesh_binary.hpp
+};
+
+struct SaveOptions {
+    MeshFormat mesh = MeshFormat::Binary;
+    bool etc1 = false; // ajoute une version ETC1 (+ alpha) de chaque texture, voir etc1.hpp
+    bool aligned = false; // profil aligné : tout stocké, mesh et textures pré-décodées lisibles par mmap (archive.hpp)
+    bool quantize = false; // meshb : sommets en 16 bits relatifs à la boîte de chaque surface (vertex_quant.hpp)
 };
 
 class Objx {
 public:
 	Objx();
-    static Objx open(const std::string& path);             // À implémenter plus tard
-    static Objx buildFromPNG(const std::string& imagePath);     // Mode interactif de création
+    static Objx open(const std::string& path, ArchiveAccess access = ArchiveAccess::Mapped); // voir readArchive
+    // Mode interactif de création ; autoOutline : triangles tirés de l'alpha (outline.hpp), retouchables ensuite
+    static Objx buildFromPNG(const std::string& imagePath, bool autoOutline = false);
 
-    bool save();                      // met aussi à jour emplacement
+    bool save(const SaveOptions& options = SaveOptions()); // met aussi à jour emplacement
 	string toString();
 
     void addSurface(const Surfaces& surface);
 	std::vector<Surfaces>& getSurfaces();
+    const std::vector<Surfaces>& getSurfaces() const;
     string getEmplacement() const;
     void setEmplacement(string path);
 
+    // Fichiers de l'archive gardés en mémoire (textures), indexés par nom d'entrée
+    const Blob* getEmbedded(const string& name) const;
+    void embed(const string& name, const Blob& data); // reprise telle quelle par la prochaine save (world.hpp)
+
+    void updateBounds(); // recalcule les boîtes des surfaces et de l'objet (fait par open et buildFromPNG)
+    const Aabb& getBounds() const;
+
 private:
     std::vector<Surfaces> surfaces;
+    std::map<string, Blob> embedded;
+    Aabb bounds;
     string emplacement; // devient non-null quand sauvegardé
 };
 
@@ -1,8 +1,12 @@
 // Objx_builder.cpp
 #include "objx.hpp"
+#include "outline.hpp"
+#include "pick_grid.hpp"
+#include "profiler.hpp"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
 #include <zip.h>
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <vector>
@@ -17,17 +21,16 @@ namespace fs = filesystem;
 Objx px;
 vector<bool> selectedTriangles;
 
+// SDL et SDL_image sont initialisés par main() pour toute la durée du programme : IMG_Quit ici
+// déchargerait le lecteur PNG sous les décodages en cours sur le pool
 void decoupage() {
-    if (SDL_Init(SDL_INIT_VIDEO) != 0) {
-        cerr << "Erreur SDL_Init : " << SDL_GetError() << endl;
-        return;
-    }
-    IMG_Init(IMG_INIT_PNG);
-
     SDL_Window* win = SDL_CreateWindow("Découpage", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, SDL_WINDOW_SHOWN);
     SDL_Renderer* renderer = SDL_CreateRenderer(win, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
 
     auto& points = px.getSurfaces()[0].points;
+    auto& indices = px.getSurfaces()[0].indices; // chaque triangle = 3 indices dans points
+    unsigned& revision = px.getSurfaces()[0].revision;
+    selectedTriangles.assign(indices.size() / 3, false); // triangles déjà posés (contour automatique)
     SDL_Surface* surface = IMG_Load(px.getSurfaces()[0].texture.c_str());
     if (!surface) {
         cerr << "Erreur IMG_Load : " << IMG_GetError() << endl;
@@ -41,105 +44,149 @@ void decoupage() {
     int offsetX = 0, offsetY = 0;
     bool running = true;
     const float selectionRadius = 10.0f;
+    PickGrid grid; // sommets et triangles, mis à jour à chaque clic
+    grid.build(points, indices);
+    vector<uint32_t> picked;
 
-    while (running) {
-        int mouseX, mouseY;
-        SDL_GetMouseState(&mouseX, &mouseY);
-        int relMouseX = mouseX - offsetX;
-        int relMouseY = mouseY - offsetY;
-
-        int hoveredIndex = -1;
-        for (size_t i = 0; i < points.size(); ++i) {
-            float dx = points[i].x - relMouseX;
-            float dy = points[i].y - relMouseY;
-            if (sqrt(dx * dx + dy * dy) < selectionRadius) {
-                hoveredIndex = i;
-                break;
-            }
-        }
+    // Surcouche de l'éditeur, reconstruite seulement quand sommets, sélection, survol ou décalage changent :
+    // remplissage et arêtes dans un seul SDL_RenderGeometry, sommets dans un SDL_RenderFillRects
+    vector<SDL_Vertex> overlay;
+    vector<SDL_Rect> rects;
+    int hoveredIndex = -1;
+    bool dirty = true;
 
-        SDL_Event e;
-        while (SDL_PollEvent(&e)) {
-            if (e.type == SDL_QUIT) running = false;
-            if (e.type == SDL_KEYDOWN) {
-                switch (e.key.keysym.sym) {
-                    case SDLK_ESCAPE: running = false; break;
-                    case SDLK_LEFT: offsetX -= 10; break;
-                    case SDLK_RIGHT: offsetX += 10; break;
-                    case SDLK_UP: offsetY -= 10; break;
-                    case SDLK_DOWN: offsetY += 10; break;
-                    case SDLK_RETURN: {
-                        cout << "[Decoupage] On va enregistrer le .objx";
-                        px.save();
-                        cout << "[Decoupage] .objx enregistré!!";
-                        running = false;
-                        cout << "[Decoupage] " << px.toString();
-                        break;
+    while (running) {
+        PROFILE_FRAME();
+        {
+            PROFILE_SCOPE("decoupage events");
+            // Rien à redessiner : le thread dort jusqu'au prochain événement
+            SDL_Event e;
+            for (bool got = dirty ? SDL_PollEvent(&e) : SDL_WaitEvent(&e); got; got = SDL_PollEvent(&e)) {
+                if (e.type == SDL_QUIT) running = false;
+                if (e.type == SDL_WINDOWEVENT) dirty = true; // exposée, redimensionnée...
+                if (e.type == SDL_KEYDOWN) {
+                    switch (e.key.keysym.sym) {
+                        case SDLK_ESCAPE: running = false; break;
+                        case SDLK_LEFT: offsetX -= 10; dirty = true; break;
+                        case SDLK_RIGHT: offsetX += 10; dirty = true; break;
+                        case SDLK_UP: offsetY -= 10; dirty = true; break;
+                        case SDLK_DOWN: offsetY += 10; dirty = true; break;
+                        case SDLK_F2: PROFILE_DUMP("decoupage_trace.json"); break;
+                        case SDLK_RETURN: {
+                            cout << "[Decoupage] On va enregistrer le .objx";
+                            SaveOptions options;
+                            options.etc1 = true;
+                            options.quantize = true;
+                            px.save(options);
+                            cout << "[Decoupage] .objx enregistré!!";
+                            running = false;
+                            cout << "[Decoupage] " << px.toString();
+                            break;
+                        }
                     }
                 }
-            }
-            if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT) {
-                if (hoveredIndex != -1) {
-                    points.push_back(points[hoveredIndex]);
-                } else {
+                if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT) {
                     int x = e.button.x - offsetX;
                     int y = e.button.y - offsetY;
-                    float u = x / (float)imgW;
-                    float v = y / (float)imgH;
-                    points.push_back({(float)x, (float)y, 0.0f, u, v});
+                    int cible = grid.nearestPoint(points, (float)x, (float)y, selectionRadius);
+                    if (cible != -1) {
+                        indices.push_back(cible); // sommet partagé, pas de copie
+                    } else {
+                        float u = x / (float)imgW;
+                        float v = y / (float)imgH;
+                        indices.push_back(points.size());
+                        points.push_back({(float)x, (float)y, 0.0f, u, v});
+                        grid.addPoint(points.size() - 1, points.back());
+                    }
+                    ++revision;
+                    if (indices.size() % 3 == 0) {
+                        size_t t = indices.size() - 3;
+                        grid.addTriangle(t / 3, points[indices[t]], points[indices[t + 1]], points[indices[t + 2]]);
+                        selectedTriangles.push_back(false);
+                    }
+                    dirty = true;
                 }
-                if (points.size() % 3 == 0) selectedTriangles.push_back(false);
-            }
-            if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_RIGHT) {
-                for (size_t i = 0; i + 2 < points.size(); i += 3) {
-                    float cx = (points[i].x + points[i+1].x + points[i+2].x) / 3 + offsetX;
-                    float cy = (points[i].y + points[i+1].y + points[i+2].y) / 3 + offsetY;
-                    float dx = mouseX - cx;
-                    float dy = mouseY - cy;
-                    if (sqrt(dx * dx + dy * dy) < 15.0f) {
-                        if (i / 3 < selectedTriangles.size())
-                            selectedTriangles[i / 3] = !selectedTriangles[i / 3];
+                if (e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_RIGHT) {
+                    // Bascule les triangles sous le curseur
+                    picked.clear();
+                    grid.trianglesAt(points, indices, (float)(e.button.x - offsetX), (float)(e.button.y - offsetY), picked);
+                    for (uint32_t t : picked) {
+                        if (t < selectedTriangles.size()) selectedTriangles[t] = !selectedTriangles[t];
                     }
+                    if (!picked.empty()) dirty = true;
                 }
             }
         }
 
+        {
+            PROFILE_SCOPE("decoupage hover");
+            int mouseX, mouseY;
+            SDL_GetMouseState(&mouseX, &mouseY);
+            int survol = grid.nearestPoint(points, (float)(mouseX - offsetX), (float)(mouseY - offsetY), selectionRadius);
+            if (survol != hoveredIndex) {
+                hoveredIndex = survol;
+                dirty = true;
+            }
+        }
+        if (!dirty || !running) continue;
+        dirty = false;
+
+        {
+            PROFILE_SCOPE("decoupage overlay");
+            overlay.clear();
+            size_t triangles = indices.size() / 3;
+            for (size_t t = 0; t < triangles; ++t) {
+                SDL_Color couleur = (t < selectedTriangles.size() && selectedTriangles[t]) ? SDL_Color{100, 100, 255, 120}
+                                                                                           : SDL_Color{255, 255, 255, 100};
+                for (int j = 0; j < 3; ++j) {
+                    const Point5D& p = points[indices[t * 3 + j]];
+                    overlay.push_back({{p.x + offsetX, p.y + offsetY}, couleur, {0, 0}});
+                }
+            }
+            // Arêtes : un quad d'un pixel de large par côté, par-dessus le remplissage dans le même appel
+            const SDL_Color bleu = {0, 0, 255, 255};
+            for (size_t t = 0; t < triangles; ++t) {
+                for (int j = 0; j < 3; ++j) {
+                    const Point5D& a = points[indices[t * 3 + j]];
+                    const Point5D& b = points[indices[t * 3 + (j + 1) % 3]];
+                    float dx = b.x - a.x, dy = b.y - a.y;
+                    float len = sqrt(dx * dx + dy * dy);
+                    if (len == 0) continue;
+                    float nx = -dy / len * 0.5f, ny = dx / len * 0.5f;
+                    SDL_FPoint q[4] = {{a.x + offsetX - nx, a.y + offsetY - ny}, {a.x + offsetX + nx, a.y + offsetY + ny},
+                                       {b.x + offsetX + nx, b.y + offsetY + ny}, {b.x + offsetX - nx, b.y + offsetY - ny}};
+                    for (int k : {0, 1, 2, 0, 2, 3}) overlay.push_back({q[k], bleu, {0, 0}});
+                }
+            }
+            rects.clear();
+            for (size_t i = 0; i < points.size(); ++i) {
+                if ((int)i == hoveredIndex) continue; // dessiné à part, en jaune
+                rects.push_back({(int)(points[i].x + offsetX - 2), (int)(points[i].y + offsetY - 2), 5, 5});
+            }
+        }
+
+        PROFILE_SCOPE("decoupage render"); // jusqu'au SDL_RenderPresent inclus
         SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);
         SDL_RenderClear(renderer);
         SDL_Rect dst = {offsetX, offsetY, imgW, imgH};
         SDL_RenderCopy(renderer, texture, NULL, &dst);
 
-        for (size_t i = 0; i + 2 < points.size(); i += 3) {
-            SDL_Vertex verts[3];
-            for (int j = 0; j < 3; ++j) {
-                verts[j].position.x = points[i + j].x + offsetX;
-                verts[j].position.y = points[i + j].y + offsetY;
-                if (i / 3 < selectedTriangles.size() && selectedTriangles[i / 3]) {
-                    verts[j].color = {100, 100, 255, 120};
-                } else {
-                    verts[j].color = {255, 255, 255, 100};
-                }
-            }
-            SDL_RenderGeometry(renderer, nullptr, verts, 3, nullptr, 0);
+        if (!overlay.empty()) {
+            SDL_RenderGeometry(renderer, nullptr, overlay.data(), (int)overlay.size(), nullptr, 0);
+            PROFILE_COUNT(Counter::DrawCalls, 1);
+            PROFILE_COUNT(Counter::Vertices, overlay.size());
         }
-
         SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-        for (size_t i = 0; i < points.size(); ++i) {
-            SDL_Rect r = {(int)(points[i].x + offsetX - 2), (int)(points[i].y + offsetY - 2), 5, 5};
-            if ((int)i == hoveredIndex) {
-                SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
-                SDL_RenderFillRect(renderer, &r);
-                SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-            } else {
-                SDL_RenderFillRect(renderer, &r);
-            }
+        if (!rects.empty()) {
+            SDL_RenderFillRects(renderer, rects.data(), (int)rects.size());
+            PROFILE_COUNT(Counter::DrawCalls, 1);
         }
-
-        SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255);
-        for (size_t i = 0; i + 2 < points.size(); i += 3) {
-            SDL_RenderDrawLine(renderer, points[i].x + offsetX, points[i].y + offsetY, points[i+1].x + offsetX, points[i+1].y + offsetY);
-            SDL_RenderDrawLine(renderer, points[i+1].x + offsetX, points[i+1].y + offsetY, points[i+2].x + offsetX, points[i+2].y + offsetY);
-            SDL_RenderDrawLine(renderer, points[i+2].x + offsetX, points[i+2].y + offsetY, points[i].x + offsetX, points[i].y + offsetY);
+        if (hoveredIndex >= 0) {
+            const Point5D& p = points[hoveredIndex];
+            SDL_Rect r = {(int)(p.x + offsetX - 2), (int)(p.y + offsetY - 2), 5, 5};
+            SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
+            SDL_RenderFillRect(renderer, &r);
+            PROFILE_COUNT(Counter::DrawCalls, 1);
         }
 
         SDL_RenderPresent(renderer);
@@ -148,13 +195,25 @@ void decoupage() {
     SDL_DestroyTexture(texture);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(win);
-    IMG_Quit();
 }
 
-Objx Objx::buildFromPNG(const string& imagePath) {    
+Objx Objx::buildFromPNG(const string& imagePath, bool autoOutline) {
     px = Objx();
     px.getSurfaces()[0].texture = imagePath;
+    if (autoOutline) {
+        auto debut = chrono::steady_clock::now();
+        ImageRGBA img;
+        OutlineStats stats;
+        if (decodeImageFile(imagePath, img) && outlineSurface(img, px.getSurfaces()[0], OutlineOptions(), &stats)) {
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - debut).count();
+            cout << "[Decoupage] contour automatique : " << stats.contours << " contour(s), " << stats.holes
+                 << " trou(s), " << stats.triangles << " triangles en " << ms << " ms" << endl;
+        } else {
+            cerr << "[Decoupage] aucune zone opaque dans " << imagePath << ", découpage manuel" << endl;
+        }
+    }
     decoupage();
+    px.updateBounds();
     return px;
 }
 
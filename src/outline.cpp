@@ -0,0 +1,381 @@
+// outline.cpp
+#include "outline.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+
+using Vec2 = pair<float, float>;
+
+// Masque entouré d'une bordure vide : les cellules du bord n'ont pas de cas particulier.
+// rowUsed[y] indique une ligne du masque avec au moins un pixel plein.
+static void buildMask(const ImageRGBA& img, uint8_t threshold, vector<uint8_t>& mask, vector<uint8_t>& rowUsed) {
+    int W = img.w + 2, H = img.h + 2;
+    mask.assign((size_t)W * H, 0);
+    rowUsed.assign(H, 0);
+    threshold = max<uint8_t>(threshold, 1); // un alpha nul ne remplit jamais : les mots vides peuvent être sautés
+
+    // Octets alpha de deux pixels RGBA consécutifs, quel que soit le boutisme
+    static const unsigned char alphaBytes[8] = {0, 0, 0, 0xFF, 0, 0, 0, 0xFF};
+    uint64_t alphaMask;
+    memcpy(&alphaMask, alphaBytes, 8);
+
+    for (int y = 0; y < img.h; ++y) {
+        const unsigned char* row = &img.pixels[(size_t)y * img.w * 4];
+        uint8_t* m = &mask[(size_t)(y + 1) * W + 1];
+        uint8_t used = 0;
+        int x = 0;
+        // Deux pixels par mot de 64 bits : les plages transparentes sont sautées sans comparer chaque alpha
+        for (; x + 2 <= img.w; x += 2) {
+            uint64_t word;
+            memcpy(&word, row + (size_t)x * 4, 8);
+            if ((word & alphaMask) == 0) continue;
+            m[x] = row[x * 4 + 3] >= threshold;
+            m[x + 1] = row[x * 4 + 7] >= threshold;
+            used |= m[x] | m[x + 1];
+        }
+        for (; x < img.w; ++x) {
+            m[x] = row[x * 4 + 3] >= threshold;
+            used |= m[x];
+        }
+        rowUsed[y + 1] = used;
+    }
+}
+
+// Coins d'une cellule dans le sens horaire : haut-gauche, haut-droite, bas-droite, bas-gauche.
+// L'arête e va du coin e au coin e + 1 : haut, droite, bas, gauche.
+static const int EDGE_DX[4] = {0, 1, 0, -1}; // cellule voisine de l'autre côté de l'arête
+static const int EDGE_DY[4] = {-1, 0, 1, 0};
+static const float EDGE_X[4] = {0.0f, 0.5f, 0.0f, -0.5f}; // milieu de l'arête, depuis le centre de la cellule
+static const float EDGE_Y[4] = {-0.5f, 0.0f, 0.5f, 0.0f}; // (px, py) en pixels de l'image, bordure comprise
+
+vector<Contour> traceContours(const ImageRGBA& img, uint8_t alphaThreshold) {
+    vector<Contour> contours;
+    if (img.w <= 0 || img.h <= 0) return contours;
+    vector<uint8_t> mask, rowUsed;
+    buildMask(img, alphaThreshold, mask, rowUsed);
+    int W = img.w + 2, H = img.h + 2;
+
+    // Marching squares. En parcourant les coins d'une cellule dans le sens horaire, une arête plein -> vide
+    // est une sortie, vide -> plein une entrée ; le contour va de chaque sortie à l'entrée suivante. La cellule
+    // voisine voit cette entrée comme une sortie : on la suit de cellule en cellule jusqu'au point de départ,
+    // sans table de points. Le cas ambigu (coins pleins en diagonale) relie les deux coins pleins.
+    auto corners = [&](int px, int py, uint8_t c[4]) {
+        const uint8_t* haut = &mask[(size_t)py * W + px];
+        const uint8_t* bas = haut + W;
+        c[0] = haut[0], c[1] = haut[1], c[2] = bas[1], c[3] = bas[0];
+    };
+    vector<uint8_t> visited((size_t)W * H, 0); // sorties déjà suivies, un bit par arête
+    for (int py = 0; py + 1 < H; ++py) {
+        if (!rowUsed[py] && !rowUsed[py + 1]) continue;
+        const uint8_t* haut = &mask[(size_t)py * W];
+        const uint8_t* bas = haut + W;
+        for (int px = 0; px + 1 < W; ++px) {
+            // 8 cellules d'un coup quand les deux lignes restent identiques et constantes sur 9 échantillons
+            if (px + 9 <= W) {
+                uint64_t h0, h1, b0, b1;
+                memcpy(&h0, haut + px, 8), memcpy(&h1, haut + px + 1, 8);
+                memcpy(&b0, bas + px, 8), memcpy(&b1, bas + px + 1, 8);
+                if (h0 == h1 && b0 == b1 && h0 == b0) {
+                    px += 7;
+                    continue;
+                }
+            }
+            uint8_t c[4];
+            corners(px, py, c);
+            if (c[0] == c[1] && c[1] == c[2] && c[2] == c[3]) continue;
+            for (int e0 = 0; e0 < 4; ++e0) {
+                if (!c[e0] || c[(e0 + 1) % 4] || (visited[(size_t)py * W + px] & (1 << e0))) continue;
+
+                Contour contour;
+                int x = px, y = py, e = e0;
+                uint8_t k[4] = {c[0], c[1], c[2], c[3]};
+                do {
+                    visited[(size_t)y * W + x] |= 1 << e;
+                    contour.points.emplace_back(x + EDGE_X[e], y + EDGE_Y[e]);
+                    int f = (e + 1) % 4;
+                    while (k[f] || !k[(f + 1) % 4]) f = (f + 1) % 4; // entrée suivante
+                    x += EDGE_DX[f];
+                    y += EDGE_DY[f];
+                    e = (f + 2) % 4; // la même arête, vue de la voisine
+                    corners(x, y, k);
+                } while (x != px || y != py || e != e0);
+                if (contour.points.size() >= 3) contours.push_back(std::move(contour));
+            }
+        }
+    }
+    return contours;
+}
+
+static float signedArea(const vector<Vec2>& pts) {
+    double a = 0;
+    for (size_t i = 0, j = pts.size() - 1; i < pts.size(); j = i++) {
+        a += (double)pts[j].first * pts[i].second - (double)pts[i].first * pts[j].second;
+    }
+    return (float)(a * 0.5);
+}
+
+static float segmentDistance2(const Vec2& p, const Vec2& a, const Vec2& b) {
+    float dx = b.first - a.first, dy = b.second - a.second;
+    float len2 = dx * dx + dy * dy;
+    float t = len2 > 0 ? ((p.first - a.first) * dx + (p.second - a.second) * dy) / len2 : 0;
+    t = max(0.0f, min(1.0f, t));
+    float ex = a.first + t * dx - p.first, ey = a.second + t * dy - p.second;
+    return ex * ex + ey * ey;
+}
+
+// Douglas-Peucker sur une boucle fermée, coupée en deux au point le plus éloigné du premier
+static vector<Vec2> simplify(const vector<Vec2>& pts, float tolerance) {
+    size_t n = pts.size();
+    if (n < 4 || tolerance <= 0) return pts;
+    size_t far = 0;
+    float farD = -1;
+    for (size_t i = 1; i < n; ++i) {
+        float dx = pts[i].first - pts[0].first, dy = pts[i].second - pts[0].second;
+        if (dx * dx + dy * dy > farD) {
+            farD = dx * dx + dy * dy;
+            far = i;
+        }
+    }
+    vector<bool> keep(n + 1, false);
+    keep[0] = keep[far] = keep[n] = true;
+    vector<pair<size_t, size_t>> pile = {{0, far}, {far, n}}; // n désigne à nouveau le point 0
+    float tol2 = tolerance * tolerance;
+    while (!pile.empty()) {
+        auto [first, last] = pile.back();
+        pile.pop_back();
+        size_t best = 0;
+        float bestD = tol2;
+        for (size_t i = first + 1; i < last; ++i) {
+            float d = segmentDistance2(pts[i], pts[first], pts[last % n]);
+            if (d > bestD) {
+                bestD = d;
+                best = i;
+            }
+        }
+        if (best) {
+            keep[best] = true;
+            pile.push_back({first, best});
+            pile.push_back({best, last});
+        }
+    }
+    vector<Vec2> out;
+    for (size_t i = 0; i < n; ++i) {
+        if (keep[i]) out.push_back(pts[i]);
+    }
+    return out;
+}
+
+static bool pointInPolygon(const vector<Vec2>& poly, const Vec2& p) {
+    bool inside = false;
+    for (size_t i = 0, j = poly.size() - 1; i < poly.size(); j = i++) {
+        const Vec2& a = poly[i];
+        const Vec2& b = poly[j];
+        if ((a.second > p.second) != (b.second > p.second)
+            && p.first < (b.first - a.first) * (p.second - a.second) / (b.second - a.second) + a.first) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+static float cross(const Vec2& a, const Vec2& b, const Vec2& c) {
+    return (b.first - a.first) * (c.second - a.second) - (b.second - a.second) * (c.first - a.first);
+}
+
+static bool inTriangle(const Vec2& p, const Vec2& a, const Vec2& b, const Vec2& c) {
+    float d0 = cross(a, b, p), d1 = cross(b, c, p), d2 = cross(c, a, p);
+    bool neg = d0 < 0 || d1 < 0 || d2 < 0;
+    bool pos = d0 > 0 || d1 > 0 || d2 > 0;
+    return !(neg && pos);
+}
+
+// Relie un trou au polygone par un pont vers un sommet visible depuis son point le plus à droite
+// (méthode d'Eberly) ; le polygone devient une seule boucle qui fait le tour du trou.
+static void bridgeHole(const vector<Vec2>& pos, vector<uint32_t>& poly, const vector<uint32_t>& hole) {
+    size_t m = 0;
+    for (size_t i = 1; i < hole.size(); ++i) {
+        if (pos[hole[i]].first > pos[hole[m]].first) m = i;
+    }
+    const Vec2& M = pos[hole[m]];
+
+    // Arête la plus proche touchée par le rayon horizontal vers la droite
+    size_t p = SIZE_MAX;
+    float bestX = INFINITY;
+    for (size_t i = 0; i < poly.size(); ++i) {
+        const Vec2& a = pos[poly[i]];
+        const Vec2& b = pos[poly[(i + 1) % poly.size()]];
+        bool traverse = (a.second <= M.second && b.second >= M.second) || (a.second >= M.second && b.second <= M.second);
+        if (!traverse || a.second == b.second) continue;
+        float x = a.first + (M.second - a.second) * (b.first - a.first) / (b.second - a.second);
+        if (x < M.first || x >= bestX) continue;
+        bestX = x;
+        p = a.first > b.first ? i : (i + 1) % poly.size();
+    }
+    if (p == SIZE_MAX) return; // trou hors du polygone : ignoré
+
+    // Un sommet dans le triangle (M, I, P) masquerait P : on prend celui qui fait le plus petit angle
+    Vec2 I(bestX, M.second);
+    const Vec2 P = pos[poly[p]];
+    float bestAngle = INFINITY, bestDist = INFINITY;
+    for (size_t i = 0; i < poly.size(); ++i) {
+        const Vec2& v = pos[poly[i]];
+        if (i == p || v.first < M.first || !inTriangle(v, M, I, P)) continue;
+        float dx = v.first - M.first, dy = v.second - M.second;
+        float angle = fabs(atan2(dy, dx)), dist = dx * dx + dy * dy;
+        if (angle < bestAngle || (angle == bestAngle && dist < bestDist)) {
+            bestAngle = angle;
+            bestDist = dist;
+            p = i;
+        }
+    }
+
+    vector<uint32_t> merged(poly.begin(), poly.begin() + p + 1);
+    for (size_t k = 0; k <= hole.size(); ++k) merged.push_back(hole[(m + k) % hole.size()]); // M deux fois
+    merged.push_back(poly[p]);
+    merged.insert(merged.end(), poly.begin() + p + 1, poly.end());
+    poly.swap(merged);
+}
+
+// Découpage en oreilles ; les sommets du pont, présents deux fois, ne bloquent pas une oreille
+static void earClip(const vector<Vec2>& pos, const vector<uint32_t>& poly, vector<uint32_t>& out) {
+    size_t n = poly.size();
+    if (n < 3) return;
+    vector<Vec2> pts;
+    for (uint32_t v : poly) pts.push_back(pos[v]);
+    float sign = signedArea(pts) > 0 ? 1.0f : -1.0f;
+
+    vector<size_t> prev(n), next(n);
+    for (size_t i = 0; i < n; ++i) {
+        prev[i] = (i + n - 1) % n;
+        next[i] = (i + 1) % n;
+    }
+    auto isEar = [&](size_t a, size_t b, size_t c) {
+        const Vec2 &A = pos[poly[a]], &B = pos[poly[b]], &C = pos[poly[c]];
+        if (cross(A, B, C) * sign <= 0) return false;
+        for (size_t k = next[c]; k != a; k = next[k]) {
+            const Vec2& p = pos[poly[k]];
+            if (p == A || p == B || p == C) continue;
+            if (inTriangle(p, A, B, C)) return false;
+        }
+        return true;
+    };
+
+    size_t remaining = n, i = 0, essais = 0;
+    while (remaining > 3) {
+        size_t a = prev[i], c = next[i];
+        bool plat = cross(pos[poly[a]], pos[poly[i]], pos[poly[c]]) == 0;
+        bool oreille = !plat && isEar(a, i, c);
+        // Sans oreille après un tour complet, le polygone est dégénéré (auto-intersection) : on coupe quand même
+        if (oreille || plat || ++essais > remaining) {
+            if (!plat) out.insert(out.end(), {poly[a], poly[i], poly[c]});
+            next[a] = c;
+            prev[c] = a;
+            --remaining;
+            essais = 0;
+        }
+        i = c;
+    }
+    if (cross(pos[poly[prev[i]]], pos[poly[i]], pos[poly[next[i]]]) != 0) {
+        out.insert(out.end(), {poly[prev[i]], poly[i], poly[next[i]]});
+    }
+}
+
+bool outlineSurface(const ImageRGBA& img, Surfaces& out, const OutlineOptions& options, OutlineStats* stats) {
+    vector<Contour> contours = traceContours(img, options.alphaThreshold);
+
+    // Simplifiés ; le plus grand contour donne le sens des extérieurs, les trous tournent dans l'autre
+    struct Loop {
+        vector<Vec2> pts;
+        float area;
+        float minX, minY, maxX, maxY; // boîte, pour écarter vite les extérieurs qui ne contiennent pas un trou
+    };
+    vector<Loop> loops;
+    float largest = 0, outerSign = 1;
+    for (auto& c : contours) {
+        Loop l{simplify(c.points, options.tolerance), 0, INFINITY, INFINITY, -INFINITY, -INFINITY};
+        if (l.pts.size() < 3) continue;
+        l.area = signedArea(l.pts);
+        for (const auto& [x, y] : l.pts) {
+            l.minX = min(l.minX, x), l.maxX = max(l.maxX, x);
+            l.minY = min(l.minY, y), l.maxY = max(l.maxY, y);
+        }
+        if (fabs(l.area) < options.minArea) continue;
+        if (fabs(l.area) > largest) {
+            largest = fabs(l.area);
+            outerSign = l.area > 0 ? 1.0f : -1.0f;
+        }
+        loops.push_back(std::move(l));
+    }
+
+    vector<Vec2> pos;
+    vector<vector<uint32_t>> outers, holes;
+    vector<size_t> outerLoop;
+    vector<size_t> holeLoop;
+    vector<uint32_t> ids;
+    for (size_t i = 0; i < loops.size(); ++i) {
+        ids.clear();
+        for (const auto& p : loops[i].pts) {
+            ids.push_back((uint32_t)pos.size());
+            pos.push_back(p);
+        }
+        if (loops[i].area * outerSign > 0) {
+            outers.push_back(ids);
+            outerLoop.push_back(i);
+        } else {
+            holes.push_back(ids);
+            holeLoop.push_back(i);
+        }
+    }
+
+    // Chaque trou va au plus petit extérieur qui le contient
+    vector<vector<size_t>> holesOf(outers.size());
+    for (size_t h = 0; h < holes.size(); ++h) {
+        const Vec2& p = loops[holeLoop[h]].pts[0];
+        size_t best = SIZE_MAX;
+        for (size_t o = 0; o < outers.size(); ++o) {
+            const Loop& l = loops[outerLoop[o]];
+            if (p.first < l.minX || p.first > l.maxX || p.second < l.minY || p.second > l.maxY) continue;
+            if (!pointInPolygon(l.pts, p)) continue;
+            if (best == SIZE_MAX || fabs(l.area) < fabs(loops[outerLoop[best]].area)) best = o;
+        }
+        if (best != SIZE_MAX) holesOf[best].push_back(h);
+    }
+
+    vector<uint32_t> triangles;
+    size_t holeCount = 0;
+    for (size_t o = 0; o < outers.size(); ++o) {
+        vector<uint32_t> poly = outers[o];
+        auto& hs = holesOf[o];
+        // Trous les plus à droite d'abord : leurs ponts ne croisent pas ceux des suivants
+        sort(hs.begin(), hs.end(), [&](size_t a, size_t b) { return loops[holeLoop[a]].maxX > loops[holeLoop[b]].maxX; });
+        for (size_t h : hs) bridgeHole(pos, poly, holes[h]);
+        holeCount += hs.size();
+        earClip(pos, poly, triangles);
+    }
+
+    out.points.clear();
+    out.indices.clear();
+    if (triangles.empty()) return false;
+
+    // Seuls les sommets utilisés sont gardés (trous orphelins exclus), dans l'ordre de première utilisation
+    vector<uint32_t> remap(pos.size(), UINT32_MAX);
+    for (uint32_t v : triangles) {
+        if (remap[v] == UINT32_MAX) {
+            remap[v] = (uint32_t)out.points.size();
+            float x = pos[v].first, y = pos[v].second;
+            out.points.push_back({x, y, 0.0f, x / img.w, y / img.h});
+        }
+        out.indices.push_back(remap[v]);
+    }
+    ++out.revision;
+
+    if (stats) {
+        stats->contours = outers.size();
+        stats->holes = holeCount;
+        stats->points = out.points.size();
+        stats->triangles = out.indices.size() / 3;
+    }
+    return true;
+}
@@ -0,0 +1,34 @@
+// outline.hpp
+#pragma once
+#include "objx.hpp"
+#include "texture.hpp"
+#include <cstdint>
+#include <vector>
+
+// Découpage automatique d'une image d'après son canal alpha :
+//   masque (pixels dont alpha >= alphaThreshold), contours par marching squares,
+//   simplification (Douglas-Peucker, tolerance en pixels), puis triangulation par oreilles
+//   des contours extérieurs, les trous reliés au contour qui les entoure par un pont.
+struct OutlineOptions {
+    uint8_t alphaThreshold = 128;
+    float tolerance = 1.0f; // écart maximal entre le contour simplifié et celui du masque
+    float minArea = 4.0f;   // contours plus petits (pixels isolés, poussière) ignorés, en pixels²
+};
+
+struct OutlineStats {
+    size_t contours = 0, holes = 0;
+    size_t points = 0, triangles = 0;
+};
+
+// Contour fermé en coordonnées image (pixels, origine en haut à gauche)
+struct Contour {
+    std::vector<std::pair<float, float>> points;
+};
+
+// Contours bruts du masque ; extérieurs et trous tournent en sens opposés
+std::vector<Contour> traceContours(const ImageRGBA& img, uint8_t alphaThreshold);
+
+// Remplit points (x, y en pixels, z = 0, u/v = x/w, y/h, comme le découpage manuel) et indices.
+// Retourne false si l'image n'a aucune zone opaque assez grande.
+bool outlineSurface(const ImageRGBA& img, Surfaces& out, const OutlineOptions& options = OutlineOptions(),
+                    OutlineStats* stats = nullptr);
@@ -0,0 +1,80 @@
+// pick_grid.cpp
+#include "pick_grid.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+PickGrid::PickGrid(float cellSize) : cellSize(cellSize) {}
+
+void PickGrid::clear() {
+    cells.clear();
+}
+
+int64_t PickGrid::cellOf(float v) const {
+    return (int64_t)floor(v / cellSize);
+}
+
+void PickGrid::addPoint(uint32_t index, const Point5D& p) {
+    cells[key(cellOf(p.x), cellOf(p.y))].points.push_back(index);
+}
+
+void PickGrid::addTriangle(uint32_t triangle, const Point5D& a, const Point5D& b, const Point5D& c) {
+    int64_t x0 = cellOf(min({a.x, b.x, c.x})), x1 = cellOf(max({a.x, b.x, c.x}));
+    int64_t y0 = cellOf(min({a.y, b.y, c.y})), y1 = cellOf(max({a.y, b.y, c.y}));
+    for (int64_t cy = y0; cy <= y1; ++cy) {
+        for (int64_t cx = x0; cx <= x1; ++cx) cells[key(cx, cy)].triangles.push_back(triangle);
+    }
+}
+
+void PickGrid::build(const vector<Point5D>& points, const vector<uint32_t>& indices) {
+    clear();
+    for (size_t i = 0; i < points.size(); ++i) addPoint((uint32_t)i, points[i]);
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        addTriangle((uint32_t)(i / 3), points[indices[i]], points[indices[i + 1]], points[indices[i + 2]]);
+    }
+}
+
+int PickGrid::nearestPoint(const vector<Point5D>& points, float x, float y, float radius) const {
+    int best = -1;
+    float bestD2 = radius * radius;
+    int64_t x0 = cellOf(x - radius), x1 = cellOf(x + radius);
+    int64_t y0 = cellOf(y - radius), y1 = cellOf(y + radius);
+    for (int64_t cy = y0; cy <= y1; ++cy) {
+        for (int64_t cx = x0; cx <= x1; ++cx) {
+            auto it = cells.find(key(cx, cy));
+            if (it == cells.end()) continue;
+            for (uint32_t i : it->second.points) {
+                float dx = points[i].x - x, dy = points[i].y - y;
+                float d2 = dx * dx + dy * dy;
+                // À distance égale, le premier sommet posé l'emporte, comme l'ancien parcours linéaire
+                if (d2 < bestD2 || (d2 == bestD2 && best >= 0 && (int)i < best)) {
+                    bestD2 = d2;
+                    best = (int)i;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+// Signe du produit vectoriel (b - a) x (p - a)
+static float edge(const Point5D& a, const Point5D& b, float x, float y) {
+    return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+}
+
+void PickGrid::trianglesAt(const vector<Point5D>& points, const vector<uint32_t>& indices, float x, float y,
+                           vector<uint32_t>& out) const {
+    auto it = cells.find(key(cellOf(x), cellOf(y)));
+    if (it == cells.end()) return;
+    for (uint32_t t : it->second.triangles) {
+        const Point5D& a = points[indices[t * 3]];
+        const Point5D& b = points[indices[t * 3 + 1]];
+        const Point5D& c = points[indices[t * 3 + 2]];
+        if (edge(a, b, c.x, c.y) == 0) continue; // triangle plat : aucun intérieur
+        float e0 = edge(a, b, x, y), e1 = edge(b, c, x, y), e2 = edge(c, a, x, y);
+        // Les deux sens de rotation : l'utilisateur clique les coins dans n'importe quel ordre
+        bool inside = (e0 >= 0 && e1 >= 0 && e2 >= 0) || (e0 <= 0 && e1 <= 0 && e2 <= 0);
+        if (inside) out.push_back(t);
+    }
+}
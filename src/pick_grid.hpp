@@ -0,0 +1,41 @@
+// pick_grid.hpp
+#pragma once
+#include "objx.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Grille uniforme sur les sommets et les triangles du découpage, en pixels de l'image.
+// Les cellules vivent dans une table de hachage : pas de bornes à connaître d'avance, et chaque
+// ajout (un clic) ne touche que les cellules concernées. Une requête ne lit que quelques cellules,
+// quel que soit le nombre de sommets.
+class PickGrid {
+public:
+    explicit PickGrid(float cellSize = 32.0f);
+
+    void clear();
+    void addPoint(uint32_t index, const Point5D& p);
+    void addTriangle(uint32_t triangle, const Point5D& a, const Point5D& b, const Point5D& c); // triangle = premier coin / 3
+    // Remplit la grille depuis une surface existante (triangles complets seulement)
+    void build(const std::vector<Point5D>& points, const std::vector<uint32_t>& indices);
+
+    // Sommet le plus proche de (x, y) à moins de radius, -1 sinon
+    int nearestPoint(const std::vector<Point5D>& points, float x, float y, float radius) const;
+    // Ajoute à out les triangles qui contiennent (x, y)
+    void trianglesAt(const std::vector<Point5D>& points, const std::vector<uint32_t>& indices, float x, float y,
+                     std::vector<uint32_t>& out) const;
+
+    size_t cellCount() const { return cells.size(); }
+
+private:
+    struct Cell {
+        std::vector<uint32_t> points;
+        std::vector<uint32_t> triangles; // tous ceux dont la boîte recouvre la cellule
+    };
+    int64_t cellOf(float v) const;
+    // Décalage en non signé : cx << 32 sur un négatif est indéfini
+    static uint64_t key(int64_t cx, int64_t cy) { return (uint64_t)(uint32_t)cx << 32 | (uint32_t)cy; }
+
+    float cellSize;
+    std::unordered_map<uint64_t, Cell> cells;
+};
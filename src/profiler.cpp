@@ -0,0 +1,147 @@
+// profiler.cpp
+#include "profiler.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+const char* counterName(Counter c) {
+    switch (c) {
+        case Counter::DrawCalls: return "draw calls";
+        case Counter::TextureBinds: return "texture binds";
+        case Counter::Vertices: return "vertices";
+        case Counter::BytesUploaded: return "bytes uploaded";
+        default: return "?";
+    }
+}
+
+#ifdef ORIGAMIX_PROFILE
+
+static const size_t MAX_EVENTS = 1 << 18;
+static const double AVG_WEIGHT = 0.05; // poids de la dernière frame dans la moyenne glissante
+
+// Petit identifiant stable par thread, plus lisible dans la trace que std::thread::id
+static int threadIndex() {
+    static atomic<int> suivant{0};
+    thread_local int index = suivant++;
+    return index;
+}
+
+Profiler& Profiler::instance() {
+    static Profiler p;
+    return p;
+}
+
+// Initialisé avant main : un chronomètre ouvert avant la création du profiler reste à ts >= 0
+static const Profiler::Clock::time_point demarrage = Profiler::Clock::now();
+
+Profiler::Profiler() : origin(demarrage), frameStart(Clock::now()) {
+    for (auto& c : counters) c.store(0);
+}
+
+int64_t Profiler::micros(Clock::time_point t) const {
+    return chrono::duration_cast<chrono::microseconds>(t - origin).count();
+}
+
+void Profiler::push(Event&& e) {
+    if (events.size() < MAX_EVENTS) {
+        events.push_back(std::move(e));
+    } else {
+        events[next] = std::move(e);
+    }
+    next = (next + 1) % MAX_EVENTS;
+}
+
+void Profiler::record(const char* name, string detail, Clock::time_point start, Clock::time_point end) {
+    Event e;
+    e.name = name;
+    e.detail = std::move(detail);
+    e.tid = threadIndex();
+    e.startUs = micros(start);
+    e.durUs = micros(end) - e.startUs;
+    double ms = chrono::duration<double, milli>(end - start).count();
+
+    lock_guard<std::mutex> lock(mutex);
+    push(std::move(e));
+    auto it = find_if(frameScopes.begin(), frameScopes.end(), [&](const auto& s) { return s.first == name; });
+    if (it == frameScopes.end()) frameScopes.emplace_back(name, ms);
+    else it->second += ms;
+}
+
+void Profiler::endFrame() {
+    Clock::time_point now = Clock::now();
+    Event e;
+    e.name = "frame";
+    e.tid = threadIndex();
+    e.counter = true;
+    e.startUs = micros(now);
+    for (size_t i = 0; i < (size_t)Counter::Count; ++i) e.values[i] = counters[i].exchange(0);
+
+    lock_guard<std::mutex> lock(mutex);
+    last.ms = chrono::duration<double, milli>(now - frameStart).count();
+    last.avgMs = last.avgMs == 0 ? last.ms : last.avgMs + (last.ms - last.avgMs) * AVG_WEIGHT;
+    copy(begin(e.values), end(e.values), begin(last.counters));
+    last.scopes.swap(frameScopes);
+    frameScopes.clear();
+    sort(last.scopes.begin(), last.scopes.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+    push(std::move(e));
+    frameStart = now;
+}
+
+Profiler::FrameStats Profiler::lastFrame() const {
+    lock_guard<std::mutex> lock(mutex);
+    return last;
+}
+
+static void writeJsonString(ofstream& out, const string& s) {
+    out << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') out << '\\' << c;
+        else if ((unsigned char)c < 0x20) out << ' ';
+        else out << c;
+    }
+    out << '"';
+}
+
+bool Profiler::writeChromeTrace(const string& path) const {
+    ofstream out(path);
+    if (!out) return false;
+
+    lock_guard<std::mutex> lock(mutex);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    size_t start = events.size() < MAX_EVENTS ? 0 : next; // du plus ancien au plus récent
+    for (size_t k = 0; k < events.size(); ++k) {
+        const Event& e = events[(start + k) % events.size()];
+        if (k) out << ",\n";
+        out << "{\"name\":";
+        writeJsonString(out, e.name);
+        out << ",\"pid\":1,\"tid\":" << e.tid << ",\"ts\":" << e.startUs;
+        if (e.counter) {
+            out << ",\"ph\":\"C\",\"args\":{";
+            for (size_t i = 0; i < (size_t)Counter::Count; ++i) {
+                if (i) out << ",";
+                writeJsonString(out, counterName((Counter)i));
+                out << ":" << e.values[i];
+            }
+            out << "}}";
+        } else {
+            out << ",\"ph\":\"X\",\"dur\":" << e.durUs;
+            if (!e.detail.empty()) {
+                out << ",\"args\":{\"detail\":";
+                writeJsonString(out, e.detail);
+                out << "}";
+            }
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+    return (bool)out;
+}
+
+void Profiler::dumpChromeTrace(const string& path) const {
+    if (writeChromeTrace(path)) cout << "[profiler] trace écrite dans " << path << endl;
+    else cerr << "[profiler] impossible d'écrire " << path << endl;
+}
+
+#endif
@@ -0,0 +1,101 @@
+// profiler.hpp
+#pragma once
+#include <cstdint>
+
+// Instrumentation du viewer et du découpage, active seulement si compilé avec ORIGAMIX_PROFILE
+// (make PROFILE=1). Sinon les macros PROFILE_* ne génèrent aucun code.
+//
+//   PROFILE_SCOPE("nom")               chronomètre le bloc courant (nom : chaîne littérale)
+//   PROFILE_SCOPE_DETAIL("nom", texte) idem, avec un détail (chemin de l'Objx...) visible dans la trace
+//   PROFILE_COUNT(Counter::X, n)       ajoute n au compteur de la frame en cours
+//   PROFILE_FRAME()                    clôt la frame : statistiques pour l'overlay, compteurs dans la trace
+//   PROFILE_DUMP(chemin)               écrit les derniers événements au format Chrome trace
+
+enum class Counter { DrawCalls, TextureBinds, Vertices, BytesUploaded, Count };
+
+const char* counterName(Counter c);
+
+#ifdef ORIGAMIX_PROFILE
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Profiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct FrameStats {
+        double ms = 0;     // durée de la dernière frame
+        double avgMs = 0;  // moyenne glissante
+        uint64_t counters[(size_t)Counter::Count] = {};
+        std::vector<std::pair<const char*, double>> scopes; // ms cumulées par nom, tous threads, décroissant
+    };
+
+    static Profiler& instance();
+
+    void record(const char* name, std::string detail, Clock::time_point start, Clock::time_point end);
+    void add(Counter c, uint64_t n) { counters[(size_t)c].fetch_add(n, std::memory_order_relaxed); }
+    void endFrame();
+
+    FrameStats lastFrame() const;
+    bool writeChromeTrace(const std::string& path) const; // format "trace event", ouvrable dans chrome://tracing
+    void dumpChromeTrace(const std::string& path) const;  // writeChromeTrace + message dans la console
+
+private:
+    struct Event {
+        const char* name = nullptr;
+        std::string detail;
+        int tid = 0;
+        int64_t startUs = 0, durUs = 0;
+        bool counter = false; // événement "C" : valeurs des compteurs à startUs
+        uint64_t values[(size_t)Counter::Count] = {};
+    };
+    Profiler();
+    void push(Event&& e); // mutex tenu
+    int64_t micros(Clock::time_point t) const;
+
+    Clock::time_point origin;
+    Clock::time_point frameStart;
+    std::atomic<uint64_t> counters[(size_t)Counter::Count];
+
+    mutable std::mutex mutex;
+    std::vector<Event> events; // anneau de MAX_EVENTS, le plus ancien écrasé
+    size_t next = 0;
+    std::vector<std::pair<const char*, double>> frameScopes;
+    FrameStats last;
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name, std::string detail = std::string())
+        : name(name), detail(std::move(detail)), start(Profiler::Clock::now()) {}
+    ~ProfileScope() { Profiler::instance().record(name, std::move(detail), start, Profiler::Clock::now()); }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name;
+    std::string detail;
+    Profiler::Clock::time_point start;
+};
+
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT2(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_SCOPE_DETAIL(name, detail) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name, detail)
+#define PROFILE_COUNT(counter, n) Profiler::instance().add(counter, (uint64_t)(n))
+#define PROFILE_FRAME() Profiler::instance().endFrame()
+#define PROFILE_DUMP(path) Profiler::instance().dumpChromeTrace(path)
+
+#else
+
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_SCOPE_DETAIL(name, detail) ((void)0)
+#define PROFILE_COUNT(counter, n) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_DUMP(path) ((void)0)
+
+#endif
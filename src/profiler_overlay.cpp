@@ -0,0 +1,176 @@
+// profiler_overlay.cpp
+#include "profiler_overlay.hpp"
+
+#ifdef ORIGAMIX_PROFILE
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static const char* FONT_PATH = "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf";
+static const int FONT_SIZE = 13;
+static const size_t MAX_SCOPE_LINES = 8;
+
+static const char* overlayVertexSrc = R"(
+    #version 100
+    attribute vec2 aPos; // pixels, origine en haut à gauche
+    varying vec2 vTexCoord;
+    uniform vec2 size;   // texte, en pixels
+    uniform vec2 window; // fenêtre, en pixels
+    void main() {
+        vTexCoord = aPos;
+        vec2 p = aPos * size / window;
+        gl_Position = vec4(p.x * 2.0 - 1.0, 1.0 - p.y * 2.0, 0.0, 1.0);
+    }
+)";
+
+static const char* overlayFragmentSrc = R"(
+    #version 100
+    precision mediump float;
+    uniform sampler2D tex;
+    varying vec2 vTexCoord;
+    void main() {
+        vec4 c = texture2D(tex, vTexCoord);
+        gl_FragColor = vec4(c.rgb, max(c.a, 0.6)); // fond sombre semi-transparent sous le texte
+    }
+)";
+
+static GLuint compile(GLenum type, const char* src) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &src, nullptr);
+    glCompileShader(shader);
+    return shader;
+}
+
+ProfilerText::ProfilerText() {
+    font = TTF_OpenFont(FONT_PATH, FONT_SIZE);
+    if (!font) cerr << "[profiler] police introuvable : " << FONT_PATH << endl;
+}
+
+ProfilerText::~ProfilerText() {
+    if (font) TTF_CloseFont(font);
+}
+
+ProfilerOverlay::ProfilerOverlay(int windowWidth, int windowHeight)
+    : windowWidth(windowWidth), windowHeight(windowHeight) {
+    program = glCreateProgram();
+    GLuint vs = compile(GL_VERTEX_SHADER, overlayVertexSrc);
+    GLuint fs = compile(GL_FRAGMENT_SHADER, overlayFragmentSrc);
+    glAttachShader(program, vs);
+    glAttachShader(program, fs);
+    glBindAttribLocation(program, 0, "aPos");
+    glLinkProgram(program);
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+    sizeLoc = glGetUniformLocation(program, "size");
+    windowLoc = glGetUniformLocation(program, "window");
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+ProfilerOverlay::~ProfilerOverlay() {
+    if (texture) glDeleteTextures(1, &texture);
+    if (program) glDeleteProgram(program);
+}
+
+bool ProfilerText::update(OverlayImage& out) {
+    unsigned now = SDL_GetTicks();
+    if (!font || (lastRefresh && now - lastRefresh < REFRESH_MS)) return false;
+    lastRefresh = now;
+
+    Profiler::FrameStats stats = Profiler::instance().lastFrame();
+    vector<string> lines;
+    char buf[128];
+    snprintf(buf, sizeof buf, "frame %6.2f ms  (moy. %6.2f ms, %5.1f fps)", stats.ms, stats.avgMs,
+             stats.avgMs > 0 ? 1000.0 / stats.avgMs : 0.0);
+    lines.push_back(buf);
+    for (size_t i = 0; i < (size_t)Counter::Count; ++i) {
+        snprintf(buf, sizeof buf, "%-15s %12llu", counterName((Counter)i), (unsigned long long)stats.counters[i]);
+        lines.push_back(buf);
+    }
+    for (size_t i = 0; i < min(stats.scopes.size(), MAX_SCOPE_LINES); ++i) {
+        snprintf(buf, sizeof buf, "%-24.24s %8.3f ms", stats.scopes[i].first, stats.scopes[i].second);
+        lines.push_back(buf);
+    }
+
+    // Les lignes sont rendues puis empilées dans une seule image RGBA
+    vector<SDL_Surface*> rendered;
+    int w = 1, h = 0;
+    for (const auto& line : lines) {
+        SDL_Surface* s = TTF_RenderUTF8_Blended(font, line.c_str(), SDL_Color{255, 255, 255, 255});
+        SDL_Surface* rgba = s ? SDL_ConvertSurfaceFormat(s, SDL_PIXELFORMAT_RGBA32, 0) : nullptr;
+        if (s) SDL_FreeSurface(s);
+        if (!rgba) continue;
+        rendered.push_back(rgba);
+        w = max(w, rgba->w);
+        h += rgba->h;
+    }
+    if (h == 0) return false;
+
+    vector<unsigned char> pixels((size_t)w * h * 4, 0);
+    int y = 0;
+    for (SDL_Surface* s : rendered) {
+        for (int row = 0; row < s->h; ++row) {
+            memcpy(&pixels[((size_t)(y + row) * w) * 4], static_cast<unsigned char*>(s->pixels) + (size_t)row * s->pitch,
+                   (size_t)s->w * 4);
+        }
+        y += s->h;
+        SDL_FreeSurface(s);
+    }
+    out.w = w;
+    out.h = h;
+    out.pixels = std::move(pixels);
+    return true;
+}
+
+void ProfilerOverlay::setImage(const OverlayImage& image) {
+    if (image.w <= 0 || image.h <= 0) return;
+    GLint previousTexture = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.w, image.h, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels.data());
+    glBindTexture(GL_TEXTURE_2D, previousTexture);
+    texW = image.w;
+    texH = image.h;
+}
+
+void ProfilerOverlay::draw() {
+    if (!visible || texW == 0) return;
+
+    GLint previousProgram = 0, previousTexture = 0, previousBuffer = 0, viewport[4];
+    glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &previousBuffer);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    static const GLfloat quad[] = {0, 0, 1, 0, 0, 1, 1, 1};
+    glUseProgram(program);
+    glUniform2f(sizeLoc, (float)texW, (float)texH);
+    glUniform2f(windowLoc, (float)windowWidth, (float)windowHeight);
+    glViewport(0, 0, windowWidth, windowHeight);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, quad);
+    glEnableVertexAttribArray(0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glDisable(GL_BLEND);
+
+    glUseProgram(previousProgram);
+    glBindTexture(GL_TEXTURE_2D, previousTexture);
+    glBindBuffer(GL_ARRAY_BUFFER, previousBuffer);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+#endif
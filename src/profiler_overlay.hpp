@@ -0,0 +1,55 @@
+// profiler_overlay.hpp
+#pragma once
+#include "profiler.hpp"
+
+#ifdef ORIGAMIX_PROFILE
+#include <SDL2/SDL_opengles2.h>
+#include <SDL2/SDL_ttf.h>
+
+#include <vector>
+
+// Texte de l'overlay déjà rasterisé, en RGBA
+struct OverlayImage {
+    int w = 0, h = 0;
+    std::vector<unsigned char> pixels;
+};
+
+// Rasterise les statistiques du profiler quelques fois par seconde. Thread principal seulement : SDL_ttf
+// (FreeType) n'est utilisé que par lui, comme par la boîte de dialogue ; TTF_Init/TTF_Quit sont faits par main().
+class ProfilerText {
+public:
+    static const unsigned REFRESH_MS = 250;
+
+    ProfilerText();
+    ~ProfilerText();
+    ProfilerText(const ProfilerText&) = delete;
+    ProfilerText& operator=(const ProfilerText&) = delete;
+
+    bool update(OverlayImage& out); // true si out contient une nouvelle image
+
+private:
+    TTF_Font* font = nullptr;
+    unsigned lastRefresh = 0; // SDL_GetTicks
+};
+
+// Image de ProfilerText affichée en haut à gauche de la fenêtre GL ; dessiner coûte un quad.
+class ProfilerOverlay {
+public:
+    ProfilerOverlay(int windowWidth, int windowHeight); // thread GL
+    ~ProfilerOverlay();
+    ProfilerOverlay(const ProfilerOverlay&) = delete;
+    ProfilerOverlay& operator=(const ProfilerOverlay&) = delete;
+
+    void toggle() { visible = !visible; }
+    void setImage(const OverlayImage& image); // thread GL : envoyée à la texture
+    void draw(); // restaure programme, viewport et texture liés
+
+private:
+    GLuint program = 0;
+    GLuint texture = 0;
+    GLint sizeLoc = -1, windowLoc = -1;
+    int windowWidth, windowHeight;
+    int texW = 0, texH = 0;
+    bool visible = true;
+};
+#endif
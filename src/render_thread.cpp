@@ -0,0 +1,270 @@
+// render_thread.cpp
+#include "render_thread.hpp"
+#include "gpu_mesh.hpp"
+#include "texture_streamer.hpp"
+#include "scene.hpp"
+#include "asset_loader.hpp"
+#include "hot_reload.hpp"
+#include "world.hpp"
+#include "profiler_overlay.hpp"
+#include <SDL2/SDL_opengles2.h>
+#include <iostream>
+#include <memory>
+
+using namespace std;
+
+static const int VIEWPORT_FACTOR = 5; // glViewport couvre 5x la fenêtre, centrée : seul 1/5 de [-1,1] est à l'écran
+static const size_t TEXTURE_UPLOAD_BUDGET = 4 * 1024 * 1024; // octets envoyés au GPU par frame au maximum
+static const chrono::nanoseconds FRAME_PERIOD(1000000000 / 60); // sans synchro verticale
+static const size_t WORLD_MAX_RESIDENT = 64; // chunks en mémoire par monde
+
+static const char* vertexShaderSrc = R"(
+    #version 100
+    attribute vec2 aTexCoord;
+    varying vec2 vTexCoord;
+    attribute vec4 vPosition;
+    uniform float angleX;
+    uniform float angleY;
+    uniform float offsetX;
+    uniform float offsetY;
+    uniform float scale;
+    uniform vec3 posMin;    // sommets en 16 bits normalisés (GpuMeshCache::setDequantization)
+    uniform vec3 posExtent;
+    uniform vec4 uvRange;   // UV min, UV étendue
+    void main() {
+        float cosX = cos(angleX);
+        float sinX = sin(angleX);
+        float cosY = cos(angleY);
+        float sinY = sin(angleY);
+        vec3 pos = posMin + vPosition.xyz * posExtent;
+
+        float y = pos.y * cosX - pos.z * sinX;
+        float z = pos.y * sinX + pos.z * cosX;
+        float x = pos.x * cosY + z * sinY;
+        z = -pos.x * sinY + z * cosY;
+
+        gl_Position = vec4(x*scale + offsetX, y*scale + offsetY, z*scale, z + 2.0);
+        vTexCoord = uvRange.xy + aTexCoord * uvRange.zw;
+    }
+)";
+
+static const char* fragmentShaderSrc = R"(
+    #version 100
+    precision mediump float;
+    uniform sampler2D tex;
+    uniform sampler2D texAlpha;
+    uniform float alphaSeparee;
+    varying vec2 vTexCoord;
+    void main() {
+        vec4 color = texture2D(tex, vTexCoord);
+        if (alphaSeparee > 0.5) color.a = texture2D(texAlpha, vTexCoord).g; // ETC1 : alpha dans une seconde texture
+        gl_FragColor = color;
+    }
+)";
+
+static GLuint compileShader(GLenum type, const char* src) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &src, nullptr);
+    glCompileShader(shader);
+    GLint success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        char log[512];
+        glGetShaderInfoLog(shader, 512, nullptr, log);
+        cerr << "[Shader Compilation Error] " << log << endl;
+    }
+    return shader;
+}
+
+static GLuint createProgram() {
+    GLuint vs = compileShader(GL_VERTEX_SHADER, vertexShaderSrc);
+    GLuint fs = compileShader(GL_FRAGMENT_SHADER, fragmentShaderSrc);
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vs);
+    glAttachShader(program, fs);
+    glBindAttribLocation(program, 0, "vPosition");
+    glBindAttribLocation(program, 1, "aTexCoord");
+    glLinkProgram(program);
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        char log[512];
+        glGetProgramInfoLog(program, 512, nullptr, log);
+        cerr << "[Program Link Error] " << log << endl;
+    }
+    return program;
+}
+
+void FramePacer::wait() {
+    next += period;
+    auto now = chrono::steady_clock::now();
+    if (next < now) {
+        next = now;
+        return;
+    }
+    this_thread::sleep_until(next);
+}
+
+RenderThread::RenderThread(SDL_Window* window, SDL_GLContext context, int width, int height, vector<string> archives,
+                           vector<string> worlds)
+    : window(window), context(context), width(width), height(height), archives(std::move(archives)),
+      worlds(std::move(worlds)) {
+    thread = std::thread([this]() { run(); });
+}
+
+RenderThread::~RenderThread() {
+    stop();
+}
+
+void RenderThread::publish(const FrameState& state) {
+    frames.back() = state;
+    frames.publish();
+}
+
+void RenderThread::submit(SceneCommand&& command) {
+    lock_guard<mutex> lock(commandsMutex);
+    commands.push_back(std::move(command));
+}
+
+void RenderThread::stop() {
+    running = false;
+    if (thread.joinable()) thread.join();
+}
+
+void RenderThread::takeCommands(vector<SceneCommand>& out) {
+    lock_guard<mutex> lock(commandsMutex);
+    out.swap(commands);
+}
+
+void RenderThread::takeFrameTimes(vector<chrono::steady_clock::time_point>& out) {
+    lock_guard<mutex> lock(framesMutex);
+    out.insert(out.end(), frameTimes.begin(), frameTimes.end());
+    frameTimes.clear();
+}
+
+#ifdef ORIGAMIX_PROFILE
+void RenderThread::publishOverlay(OverlayImage&& image) {
+    lock_guard<mutex> lock(overlayMutex);
+    overlayImage = std::move(image);
+    overlayNew = true;
+}
+#endif
+
+void RenderThread::run() {
+    SDL_GL_MakeCurrent(window, context);
+    bool vsync = SDL_GL_SetSwapInterval(1) == 0;
+    FramePacer pacer(FRAME_PERIOD);
+
+    GLuint program = createProgram();
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "tex"), 0);
+    glUniform1i(glGetUniformLocation(program, "texAlpha"), 1);
+    GLint alphaSepareeLoc = glGetUniformLocation(program, "alphaSeparee");
+    GLint angleXLoc = glGetUniformLocation(program, "angleX");
+    GLint angleYLoc = glGetUniformLocation(program, "angleY");
+    GLint scaleLoc  = glGetUniformLocation(program, "scale");
+    GLint offsetXLoc = glGetUniformLocation(program, "offsetX");
+    GLint offsetYLoc = glGetUniformLocation(program, "offsetY");
+
+    GpuMeshCache meshCache;
+    meshCache.setAttributes(glGetAttribLocation(program, "vPosition"), glGetAttribLocation(program, "aTexCoord"));
+    meshCache.setDequantization(glGetUniformLocation(program, "posMin"), glGetUniformLocation(program, "posExtent"),
+                                glGetUniformLocation(program, "uvRange"));
+
+    // Tout le travail CPU (zip, mesh, PNG, mipmaps) tourne sur le pool ; ce thread ne fait que les envois GL
+    auto debutChargement = chrono::steady_clock::now();
+    ThreadPool pool;
+    TextureStreamer textures(pool);
+    Scene scene(textures, meshCache);
+    scene.load(loadAssets(archives, pool));
+    double msChargement = chrono::duration<double, milli>(chrono::steady_clock::now() - debutChargement).count();
+    cout << "[démarrage] " << scene.objectCount() << " archive(s) chargée(s) en " << msChargement
+         << " ms sur " << pool.size() << " thread(s), " << scene.textureCount() << " texture(s) en streaming"
+         << (textures.supportsEtc1() ? " (ETC1 disponible)" : "") << endl;
+    bool texturesPretes = false;
+    HotReload hotReload("assets", pool, scene); // archives et textures modifiées reprises sans redémarrer
+    vector<unique_ptr<WorldStreamer>> streamers; // chunks lus autour de la vue, pas au démarrage
+    for (const auto& w : worlds) {
+        auto streamer = make_unique<WorldStreamer>(w, pool, scene, WORLD_MAX_RESIDENT);
+        if (streamer->valid()) streamers.push_back(std::move(streamer));
+    }
+
+    glViewport(-2*width, -2*height, VIEWPORT_FACTOR*width, VIEWPORT_FACTOR*height);
+#ifdef ORIGAMIX_PROFILE
+    ProfilerOverlay overlay(width, height); // F1 : afficher/masquer, F2 : trace Chrome ; texte rendu par main()
+    bool overlayVisible = true;
+    OverlayImage overlayRecue;
+#endif
+
+    vector<SceneCommand> recues;
+    while (running) {
+        {
+            PROFILE_SCOPE("commands");
+            takeCommands(recues);
+            for (auto& c : recues) {
+                if (c.kind == SceneCommand::Kind::Add) scene.add(std::move(c.objx)); // texture décodée en arrière-plan
+                else if (scene.lastUnstreamed() >= 0) scene.remove(scene.lastUnstreamed()); // chunks : au streamer
+            }
+            recues.clear();
+        }
+
+        frames.update();
+        const FrameState& state = frames.front();
+        ViewParams view = state.view;
+        view.ndcExtent = 1.0f / VIEWPORT_FACTOR;
+
+        hotReload.update();
+        for (auto& s : streamers) s->update(view);
+        textures.update(TEXTURE_UPLOAD_BUDGET);
+        if (!texturesPretes && textures.pending() == 0) {
+            texturesPretes = true;
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - debutChargement).count();
+            cout << "[démarrage] textures complètes en " << ms << " ms" << endl;
+        }
+
+        glClearColor(1, 1, 1, 1);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        {
+            PROFILE_SCOPE("uniforms");
+            glUniform1f(angleXLoc, view.angleX);
+            glUniform1f(angleYLoc, view.angleY);
+            glUniform1f(scaleLoc, view.scale);
+            glUniform1f(offsetXLoc, view.offsetX);
+            glUniform1f(offsetYLoc, view.offsetY);
+        }
+        scene.draw(alphaSepareeLoc, view);
+
+#ifdef ORIGAMIX_PROFILE
+        if (state.overlay != overlayVisible) {
+            overlay.toggle();
+            overlayVisible = state.overlay;
+        }
+        bool imageNeuve = false;
+        {
+            lock_guard<mutex> lock(overlayMutex);
+            if (overlayNew) {
+                swap(overlayRecue, overlayImage);
+                overlayNew = false;
+                imageNeuve = true;
+            }
+        }
+        if (imageNeuve) overlay.setImage(overlayRecue);
+        overlay.draw();
+#endif
+        SDL_GL_SwapWindow(window);
+        if (recording) {
+            lock_guard<mutex> lock(framesMutex);
+            frameTimes.push_back(chrono::steady_clock::now());
+        }
+        if (!vsync) pacer.wait();
+        PROFILE_FRAME();
+    }
+
+    streamers.clear();
+    scene.clear();
+    meshCache.clear();
+    textures.clear();
+    glDeleteProgram(program);
+    SDL_GL_MakeCurrent(window, nullptr);
+}
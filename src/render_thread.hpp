@@ -0,0 +1,86 @@
+// render_thread.hpp
+#pragma once
+#include "culling.hpp"
+#include "profiler_overlay.hpp"
+#include "objx.hpp"
+#include "triple_buffer.hpp"
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Tout ce qu'une frame dessine, recopié par le thread principal à chaque changement
+struct FrameState {
+    ViewParams view;
+    bool overlay = true; // overlay du profiler (F1), si compilé
+};
+
+// Modification de la scène demandée par le thread principal, appliquée entre deux frames.
+// Passe par une file et non par FrameState : aucune ne doit être perdue.
+struct SceneCommand {
+    enum class Kind { Add, RemoveLast }; // RemoveLast : dernier objet hors chunks de monde
+    Kind kind = Kind::Add;
+    Objx objx; // Add
+};
+
+// Échéances fixes quand la synchro verticale manque : une frame en retard repart de maintenant
+// au lieu d'enchaîner les suivantes pour rattraper
+class FramePacer {
+public:
+    explicit FramePacer(std::chrono::nanoseconds period) : period(period), next(std::chrono::steady_clock::now()) {}
+    void wait();
+
+private:
+    std::chrono::nanoseconds period;
+    std::chrono::steady_clock::time_point next;
+};
+
+// Thread qui possède le contexte GL : chargement initial, scène, streaming des textures et des chunks
+// de monde, rechargement à chaud et dessin. Le thread principal ne fait plus que les entrées, les boîtes de dialogue et la
+// construction d'objets ; ce qu'il bloque ne gèle plus l'affichage.
+class RenderThread {
+public:
+    // Le contexte ne doit plus être courant sur le thread appelant ; worlds : dossiers "<nom>.world" (world.hpp)
+    RenderThread(SDL_Window* window, SDL_GLContext context, int width, int height, std::vector<std::string> archives,
+                 std::vector<std::string> worlds = {});
+    ~RenderThread(); // stop()
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    void publish(const FrameState& state); // thread principal, sans attente
+    void submit(SceneCommand&& command);    // thread principal
+    void stop();                            // scène et ressources GL libérées, contexte rendu
+    // Instant de chaque échange de tampons depuis le dernier appel, si recordFrames (mesure de régularité)
+    void recordFrames(bool on) { recording = on; }
+    void takeFrameTimes(std::vector<std::chrono::steady_clock::time_point>& out);
+#ifdef ORIGAMIX_PROFILE
+    void publishOverlay(OverlayImage&& image); // thread principal (ProfilerText) ; la plus récente l'emporte
+#endif
+
+private:
+    void run();
+    void takeCommands(std::vector<SceneCommand>& out);
+
+    SDL_Window* window;
+    SDL_GLContext context;
+    int width, height;
+    std::vector<std::string> archives;
+    std::vector<std::string> worlds;
+
+    TripleBuffer<FrameState> frames;
+    std::mutex commandsMutex;
+    std::vector<SceneCommand> commands;
+    std::mutex framesMutex;
+    std::vector<std::chrono::steady_clock::time_point> frameTimes;
+    std::atomic<bool> recording{false};
+#ifdef ORIGAMIX_PROFILE
+    std::mutex overlayMutex;
+    OverlayImage overlayImage;
+    bool overlayNew = false;
+#endif
+    std::atomic<bool> running{true};
+    std::thread thread;
+};
@@ -0,0 +1,459 @@
+// scene.cpp
+#include "scene.hpp"
+#include "atlas.hpp"
+#include "etc1.hpp"
+#include "mesh_lod.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <set>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const int ATLAS_PAGE_SIZE = 2048;
+static const int ATLAS_MAX_TEXTURE = 512;       // au-delà, la texture garde sa propre page
+static const size_t BATCH_MAX_VERTICES = 65536; // un lot reste indexable en 16 bits
+// Maillage complet tant que l'objet couvre au moins ce quart de la fenêtre, puis un niveau de plus (deux fois
+// moins de triangles, écart toléré doublé, voir mesh_lod.hpp) chaque fois que cette part est divisée par deux :
+// l'écart reste autour d'un pixel à l'écran
+static const float LOD_FULL_SCREEN = 0.25f;
+static const float LOD_HYSTERESIS = 0.15f; // marge autour des seuils : pas de va-et-vient pendant un zoom
+
+static string textureName(const Surfaces& s) {
+    return fs::path(s.texture).filename().string();
+}
+
+// Octets encodés de la texture : l'entrée de l'archive, sinon le fichier externe (mode construction)
+static Blob encodedBytes(const Objx& objx, const Surfaces& s) {
+    const Blob* png = objx.getEmbedded(textureName(s));
+    return png ? *png : Blob::fromFile(s.texture);
+}
+
+// Hors de [0,1], la texture se répéterait ou déborderait sur ses voisines de page
+static bool uvInUnitSquare(const Surfaces& s) {
+    for (const auto& p : s.points) {
+        if (p.u < 0 || p.u > 1 || p.v < 0 || p.v > 1) return false;
+    }
+    return true;
+}
+
+// Seuil bas du niveau : en dessous, le suivant suffit
+static float lodThreshold(size_t level) {
+    return ldexp(LOD_FULL_SCREEN, -(int)level);
+}
+
+static size_t selectLod(float part, size_t current, size_t count) {
+    current = min(current, count - 1);
+    float haut = current == 0 ? INFINITY : lodThreshold(current - 1);
+    float bas = current + 1 == count ? 0.0f : lodThreshold(current);
+    if (part >= bas * (1 - LOD_HYSTERESIS) && part < haut * (1 + LOD_HYSTERESIS)) return current;
+    size_t level = 0;
+    while (level + 1 < count && part < lodThreshold(level)) ++level;
+    return level;
+}
+
+Scene::Scene(TextureStreamer& textures, GpuMeshCache& meshes) : textures(textures), meshes(meshes) {}
+
+Scene::TextureKey Scene::textureKey(SceneObject& obj, const Surfaces& s) {
+    string name = textureName(s);
+    auto it = obj.keys.find(name);
+    if (it != obj.keys.end()) return it->second;
+    Blob bytes = encodedBytes(obj.objx, s);
+    TextureKey key(hashBytes(bytes.data, bytes.size), bytes.size);
+    // Clé déjà prise par d'autres octets de même taille : la suivante, jusqu'à la même image ou une clé libre.
+    // Une clé rendue mais suivie d'autres reste, vide (releaseObject) : la chaîne continue derrière elle
+    bool trouvee = bytes.size == 0, videe = false;
+    TextureKey libre;
+    for (auto it = encoded.find(key); !trouvee && it != encoded.end(); it = encoded.find(key)) {
+        if (!it->second.data) {
+            if (!videe) libre = key, videe = true;
+        } else if (memcmp(it->second.data, bytes.data, bytes.size) == 0) {
+            trouvee = true;
+            break;
+        }
+        ++key.first;
+    }
+    if (!trouvee && videe) key = libre;
+    if (!trouvee || !encoded.count(key)) encoded[key] = bytes;
+    obj.keys.emplace(name, key);
+    return key;
+}
+
+// Octets déjà lus par textureKey : un fichier externe n'est pas relu
+TextureStreamer::Handle Scene::requestTexture(const Objx& objx, const Surfaces& s, TextureKey key) {
+    string name = textureName(s);
+    const Blob* etc1 = objx.getEmbedded(etc1EntryName(name));
+    const Blob* raw = objx.getEmbedded(rawTextureEntryName(name));
+    auto it = encoded.find(key);
+    TextureStreamer::Handle h = textures.request(it != encoded.end() ? it->second : encodedBytes(objx, s), etc1, raw);
+    ++handleRefs[h];
+    return h;
+}
+
+// Une référence par objet et par image, rendue par releaseObject. Une image de l'atlas prend en plus sa
+// propre texture pour une surface ajoutée après coup dont les UV sortent de [0,1]
+const Scene::TextureRef* Scene::acquireTexture(SceneObject& obj, const Surfaces& s) {
+    if (s.texture.empty()) return nullptr;
+    TextureKey key = textureKey(obj, s);
+    auto it = textureRefs.find(key);
+    if (it == textureRefs.end()) {
+        TextureRef ref;
+        ref.handle = requestTexture(obj.objx, s, key);
+        it = textureRefs.emplace(key, ref).first;
+    }
+    if (it->second.inAtlas && !it->second.hasStandalone && !uvInUnitSquare(s)) {
+        it->second.standalone = requestTexture(obj.objx, s, key);
+        it->second.hasStandalone = true;
+    }
+    if (find(obj.textures.begin(), obj.textures.end(), key) == obj.textures.end()) {
+        obj.textures.push_back(key);
+        ++it->second.refs;
+    }
+    return &it->second;
+}
+
+void Scene::releaseObject(SceneObject& obj) {
+    for (auto& b : obj.batches) meshes.release(b->mesh);
+    for (const auto& key : obj.textures) {
+        auto it = textureRefs.find(key);
+        if (it == textureRefs.end() || --it->second.refs > 0) continue;
+        releaseHandle(it->second.handle);
+        if (it->second.hasStandalone) releaseHandle(it->second.standalone);
+        textureRefs.erase(it);
+        // Retirer une clé au milieu d'une chaîne de sondage couperait les suivantes : elle reste, vide.
+        // En bout de chaîne, retirée avec les clés vides qui la précèdent
+        if (encoded.count(TextureKey(key.first + 1, key.second))) {
+            encoded[key] = Blob();
+            continue;
+        }
+        encoded.erase(key);
+        for (TextureKey k(key.first - 1, key.second);; --k.first) {
+            auto e = encoded.find(k);
+            if (e == encoded.end() || e->second.data) break;
+            encoded.erase(e);
+        }
+    }
+    obj.textures.clear();
+}
+
+// Une page d'atlas reste en vie tant qu'une des textures qu'elle contient sert encore
+void Scene::releaseHandle(TextureStreamer::Handle h) {
+    auto it = handleRefs.find(h);
+    if (it == handleRefs.end() || --it->second > 0) return;
+    handleRefs.erase(it);
+    textures.release(h);
+}
+
+void Scene::buildAtlas(const vector<unique_ptr<SceneObject>>& nouveaux) {
+    struct Candidate {
+        TextureKey key;
+        Blob png;
+        int w = 0, h = 0;
+    };
+    map<TextureKey, Candidate> candidates;
+    set<TextureKey> rejected;
+    for (const auto& obj : nouveaux) {
+        for (const auto& s : obj->objx.getSurfaces()) {
+            if (s.texture.empty() || s.cornerCount() < 3) continue; // mêmes surfaces que buildBatches
+            TextureKey key = textureKey(*obj, s);
+            if (textureRefs.count(key) || rejected.count(key)) continue;
+
+            string name = textureName(s);
+            Candidate c{key, Blob(), 0, 0};
+            const Blob* png = obj->objx.getEmbedded(name);
+            bool prefersEtc1 = textures.supportsEtc1() && obj->objx.getEmbedded(etc1EntryName(name));
+            bool prefersRaw = obj->objx.getEmbedded(rawTextureEntryName(name)) != nullptr; // envoyée sans décodage
+            bool ok = png && !prefersEtc1 && !prefersRaw && pngSize(*png, c.w, c.h)
+                   && c.w <= ATLAS_MAX_TEXTURE && c.h <= ATLAS_MAX_TEXTURE && uvInUnitSquare(s);
+            if (!ok) {
+                rejected.insert(key);
+                candidates.erase(key);
+                continue;
+            }
+            c.png = *png;
+            candidates.emplace(key, c); // même contenu ailleurs : la même place dans l'atlas
+        }
+    }
+    if (candidates.size() < 2) return; // rien à regrouper
+
+    vector<Candidate> sorted;
+    for (auto& [key, c] : candidates) sorted.push_back(c);
+    sort(sorted.begin(), sorted.end(), [](const Candidate& a, const Candidate& b) { return a.h > b.h; });
+
+    vector<SkylinePacker> packers;
+    vector<vector<AtlasSource>> pages;
+    vector<pair<TextureKey, size_t>> pageOf;
+    for (const auto& c : sorted) {
+        int x = 0, y = 0;
+        size_t page = 0;
+        int pw = c.w + 2 * ATLAS_GUTTER, ph = c.h + 2 * ATLAS_GUTTER;
+        while (page < packers.size() && !packers[page].insert(pw, ph, x, y)) ++page;
+        if (page == packers.size()) {
+            packers.emplace_back(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+            pages.emplace_back();
+            packers.back().insert(pw, ph, x, y);
+        }
+        pages[page].push_back({c.png, x + ATLAS_GUTTER, y + ATLAS_GUTTER});
+
+        TextureRef ref;
+        ref.inAtlas = true;
+        ref.u0 = (float)(x + ATLAS_GUTTER) / ATLAS_PAGE_SIZE;
+        ref.v0 = (float)(y + ATLAS_GUTTER) / ATLAS_PAGE_SIZE;
+        ref.su = (float)c.w / ATLAS_PAGE_SIZE;
+        ref.sv = (float)c.h / ATLAS_PAGE_SIZE;
+        textureRefs[c.key] = ref; // refs à 0 : chaque objet prend la sienne dans buildBatches
+        pageOf.emplace_back(c.key, page);
+    }
+
+    vector<TextureStreamer::Handle> handles;
+    for (auto& sources : pages) {
+        handles.push_back(textures.requestImage([sources](ImageRGBA& img) {
+            return composeAtlasPage(sources, ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, img);
+        }));
+    }
+    for (auto& [key, page] : pageOf) {
+        textureRefs[key].handle = handles[page];
+        ++handleRefs[handles[page]];
+    }
+
+    cout << "[atlas] " << sorted.size() << " textures rangées dans " << pages.size()
+         << " page(s) de " << ATLAS_PAGE_SIZE << "x" << ATLAS_PAGE_SIZE << endl;
+}
+
+void Scene::buildBatches(SceneObject& obj) {
+    obj.levels = 1;
+    for (const auto& s : obj.objx.getSurfaces()) {
+        if (!s.indices.empty()) obj.levels = max(obj.levels, s.lods.size() + 1);
+    }
+    // Indices par lot et par niveau, mis bout à bout une fois tous les lots remplis
+    map<DrawBatch*, vector<vector<uint32_t>>> niveaux;
+
+    for (const auto& s : obj.objx.getSurfaces()) {
+        if (s.cornerCount() < 3) continue;
+        const TextureRef* ref = acquireTexture(obj, s);
+        if (!ref) continue;
+        bool remap = ref->inAtlas && uvInUnitSquare(s);
+        TextureStreamer::Handle handle = ref->inAtlas && !remap ? ref->standalone : ref->handle;
+
+        // Dernier lot de cette texture, s'il reste de la place
+        DrawBatch* batch = nullptr;
+        for (auto& b : obj.batches) {
+            if (b->texture == handle) batch = b.get();
+        }
+        if (!batch || (batch->mesh.points.size() && batch->mesh.points.size() + s.points.size() > BATCH_MAX_VERTICES)) {
+            obj.batches.push_back(make_unique<DrawBatch>());
+            batch = obj.batches.back().get();
+            batch->texture = handle;
+            batch->mesh.texture = s.texture;
+            batch->levels.resize(obj.levels);
+            niveaux[batch].resize(obj.levels);
+        }
+
+        Surfaces& m = batch->mesh;
+        uint32_t base = (uint32_t)m.points.size();
+        for (const auto& p : s.points) {
+            Point5D q = p;
+            if (remap) {
+                q.u = ref->u0 + p.u * ref->su;
+                q.v = ref->v0 + p.v * ref->sv;
+            }
+            m.points.push_back(q);
+        }
+        // Une surface qui a moins de niveaux garde son plus grossier
+        for (size_t l = 0; l < obj.levels; ++l) {
+            vector<uint32_t>& out = niveaux[batch][l];
+            SurfaceRange range;
+            range.box = s.bounds;
+            range.first = out.size();
+            if (s.indices.empty()) {
+                for (uint32_t i = 0; i + 2 < s.points.size(); i += 3) {
+                    out.insert(out.end(), {base + i, base + i + 1, base + i + 2});
+                }
+            } else {
+                const vector<uint32_t>& src = lodIndices(s, l);
+                for (size_t i = 0; i + 2 < src.size(); i += 3) {
+                    out.insert(out.end(), {base + src[i], base + src[i + 1], base + src[i + 2]});
+                }
+            }
+            range.count = out.size() - range.first;
+            batch->levels[l].push_back(range);
+        }
+        m.revision++;
+    }
+    for (auto& b : obj.batches) {
+        auto& indices = niveaux[b.get()];
+        for (size_t l = 0; l < indices.size(); ++l) {
+            size_t debut = b->mesh.indices.size();
+            for (auto& r : b->levels[l]) r.first += debut;
+            b->mesh.indices.insert(b->mesh.indices.end(), indices[l].begin(), indices[l].end());
+        }
+        meshes.upload(b->mesh);
+    }
+}
+
+void Scene::load(vector<Objx>&& objxs) {
+    vector<unique_ptr<SceneObject>> nouveaux;
+    size_t drawsAvant = 0;
+    set<string> noms; // ancien registre : une texture GPU par nom de fichier
+    for (auto& objx : objxs) {
+        for (const auto& s : objx.getSurfaces()) {
+            if (s.cornerCount() >= 3 && !s.texture.empty()) {
+                ++drawsAvant; // un dessin et un bind par surface
+                noms.insert(textureName(s));
+            }
+        }
+        nouveaux.push_back(make_unique<SceneObject>());
+        nouveaux.back()->objx = std::move(objx);
+    }
+
+    buildAtlas(nouveaux);
+
+    size_t drawsApres = 0, bindsApres = 0;
+    TextureStreamer::Handle last = ~0u;
+    for (auto& obj : nouveaux) {
+        buildBatches(*obj);
+        for (auto& b : obj->batches) {
+            ++drawsApres;
+            if (b->texture != last) ++bindsApres;
+            last = b->texture;
+        }
+        objects.push_back(std::move(obj));
+    }
+    rebuildBvh();
+    cout << "[lots] appels de dessin " << drawsAvant << " -> " << drawsApres
+         << ", changements de texture " << drawsAvant << " -> " << bindsApres << endl;
+    cout << "[textures] " << drawsAvant << " surface(s) texturée(s), " << noms.size() << " nom(s) de fichier, "
+         << textureRefs.size() << " image(s) distincte(s)" << endl;
+}
+
+void Scene::add(Objx&& objx, bool streamed) {
+    objects.push_back(make_unique<SceneObject>());
+    objects.back()->objx = std::move(objx);
+    objects.back()->streamed = streamed;
+    buildBatches(*objects.back());
+    rebuildBvh();
+}
+
+void Scene::remove(size_t index) {
+    if (index >= objects.size()) return;
+    releaseObject(*objects[index]);
+    objects.erase(objects.begin() + index);
+    rebuildBvh();
+}
+
+void Scene::replace(size_t index, Objx&& objx) {
+    if (index >= objects.size()) return;
+    auto obj = make_unique<SceneObject>();
+    obj->objx = std::move(objx);
+    obj->streamed = objects[index]->streamed;
+    buildBatches(*obj); // références prises avant de rendre les anciennes : un contenu identique n'est pas renvoyé
+    releaseObject(*objects[index]);
+    objects[index] = std::move(obj);
+    rebuildBvh();
+}
+
+void Scene::refresh(size_t index) {
+    if (index >= objects.size()) return;
+    Objx copie = objects[index]->objx; // les entrées embarquées sont partagées, pas copiées
+    replace(index, std::move(copie));
+}
+
+int Scene::indexOf(const string& emplacement) const {
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (objects[i]->objx.getEmplacement() == emplacement) return (int)i;
+    }
+    return -1;
+}
+
+int Scene::lastUnstreamed() const {
+    for (size_t i = objects.size(); i-- > 0;) {
+        if (!objects[i]->streamed) return (int)i;
+    }
+    return -1;
+}
+
+vector<size_t> Scene::objectsUsingFile(const string& fileName) const {
+    vector<size_t> out;
+    for (size_t i = 0; i < objects.size(); ++i) {
+        const Objx& objx = objects[i]->objx;
+        for (const auto& s : objx.getSurfaces()) {
+            if (!s.texture.empty() && textureName(s) == fileName && !objx.getEmbedded(fileName)) {
+                out.push_back(i);
+                break;
+            }
+        }
+    }
+    return out;
+}
+
+void Scene::rebuildBvh() {
+    vector<Aabb> boxes;
+    boxes.reserve(objects.size());
+    for (auto& obj : objects) boxes.push_back(obj->objx.getBounds());
+    bvh.build(boxes);
+}
+
+void Scene::draw(GLint alphaSepareeLoc, const ViewParams& view) {
+    visibles.clear();
+    bvh.query(view, visibles);
+    sort(visibles.begin(), visibles.end()); // garde l'ordre de chargement, donc celui des binds
+
+    GLuint lastTex = 0, lastAlpha = ~0u;
+    vector<pair<size_t, size_t>> plages;
+    for (size_t o : visibles) {
+        auto& obj = objects[o];
+        PROFILE_SCOPE_DETAIL("submit objx", obj->objx.getEmplacement());
+        bool objetEntier = classify(obj->objx.getBounds(), view) == Visibility::Inside;
+        if (obj->levels > 1) obj->lod = selectLod(screenFraction(obj->objx.getBounds(), view), obj->lod, obj->levels);
+        for (auto& b : obj->batches) {
+            // Surfaces visibles du lot, les plages contiguës fusionnées en un seul appel
+            size_t first = 0, count = 0;
+            plages.clear();
+            for (const auto& r : b->levels[obj->lod]) {
+                if (!objetEntier && !isVisible(r.box, view)) continue;
+                if (count && first + count == r.first) {
+                    count += r.count;
+                } else {
+                    if (count) plages.emplace_back(first, count);
+                    first = r.first;
+                    count = r.count;
+                }
+            }
+            if (count) plages.emplace_back(first, count);
+            if (plages.empty()) continue;
+
+            GLuint alpha = textures.glAlphaTexture(b->texture);
+            if (alpha != lastAlpha) {
+                if (alpha) {
+                    glActiveTexture(GL_TEXTURE1);
+                    glBindTexture(GL_TEXTURE_2D, alpha);
+                    PROFILE_COUNT(Counter::TextureBinds, 1);
+                    glActiveTexture(GL_TEXTURE0);
+                }
+                glUniform1f(alphaSepareeLoc, alpha ? 1.0f : 0.0f);
+                lastAlpha = alpha;
+            }
+            GLuint tex = textures.glTexture(b->texture);
+            if (tex != lastTex) {
+                glBindTexture(GL_TEXTURE_2D, tex);
+                PROFILE_COUNT(Counter::TextureBinds, 1);
+                lastTex = tex;
+            }
+            for (auto& [debut, n] : plages) meshes.drawRange(b->mesh, debut, n);
+        }
+    }
+}
+
+void Scene::clear() {
+    for (auto& obj : objects) releaseObject(*obj);
+    objects.clear();
+    textureRefs.clear(); // entrées d'atlas jamais prises par un objet
+    encoded.clear();
+    handleRefs.clear();
+    bvh.build({});
+    visibles.clear();
+}
@@ -0,0 +1,84 @@
+// scene.hpp
+#pragma once
+#include "objx.hpp"
+#include "gpu_mesh.hpp"
+#include "texture_streamer.hpp"
+#include "culling.hpp"
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Objets affichés par le viewer et leur forme prête à dessiner : les surfaces d'un Objx qui partagent
+// une texture (ou une page d'atlas) sont fusionnées en un seul lot, donc un seul appel de dessin.
+class Scene {
+public:
+    Scene(TextureStreamer& textures, GpuMeshCache& meshes);
+
+    void load(std::vector<Objx>&& objxs); // démarrage : petites textures regroupées en atlas, puis lots
+    void add(Objx&& objx, bool streamed = false); // en cours de route (touche N, chunk de monde), sans atlas
+    void remove(size_t index);            // rend ses textures : libérées quand plus aucun objet ne s'en sert
+    void replace(size_t index, Objx&& objx); // même place ; les textures inchangées restent sur le GPU
+    void refresh(size_t index);           // relit ses textures externes (modifiées sur le disque)
+    int indexOf(const std::string& emplacement) const; // -1 si absent
+    int lastUnstreamed() const; // dernier objet qui n'est pas un chunk de monde (touche Suppr), -1 si aucun
+    std::vector<size_t> objectsUsingFile(const std::string& fileName) const; // texture externe de ce nom
+    // Objets puis surfaces hors champ ignorés ; chaque objet au niveau de détail de sa taille à l'écran
+    void draw(GLint alphaSepareeLoc, const ViewParams& view);
+    void clear();
+
+    size_t objectCount() const { return objects.size(); }
+    size_t textureCount() const { return textureRefs.size(); } // images distinctes, par contenu
+    size_t visibleObjectCount() const { return visibles.size(); } // lors du dernier draw
+
+private:
+    // Empreinte et taille des octets encodés (PNG) : deux fichiers identiques sous des noms différents,
+    // ou dans deux archives, ne donnent qu'une texture GPU ; détecté sans rien décoder. L'égalité est
+    // confirmée octet par octet : une collision d'empreinte reçoit une autre clé.
+    using TextureKey = std::pair<uint64_t, size_t>;
+    struct TextureRef {
+        TextureStreamer::Handle handle = 0;
+        bool inAtlas = false;
+        float u0 = 0, v0 = 0, su = 1, sv = 1; // rectangle dans la page, en coordonnées de texture
+        bool hasStandalone = false;             // inAtlas : la même image seule, pour les UV hors de [0,1]
+        TextureStreamer::Handle standalone = 0;
+        unsigned refs = 0;                    // objets qui l'utilisent
+    };
+    struct SurfaceRange {
+        Aabb box;                    // boîte de la surface d'origine
+        size_t first = 0, count = 0; // coins dans le lot
+    };
+    struct DrawBatch {
+        Surfaces mesh; // surfaces fusionnées, UV déjà remappées dans l'atlas ; indices de chaque niveau bout à bout
+        TextureStreamer::Handle texture = 0;
+        std::vector<std::vector<SurfaceRange>> levels; // par niveau de détail (0 = complet), une plage par surface
+    };
+    struct SceneObject {
+        Objx objx;
+        std::vector<std::unique_ptr<DrawBatch>> batches; // adresses stables pour GpuMeshCache
+        size_t levels = 1; // niveaux de détail de ses lots
+        size_t lod = 0;    // niveau affiché, gardé d'une frame à l'autre pour l'hystérésis
+        bool streamed = false; // chunk de monde : retiré par son WorldStreamer seulement
+        std::map<std::string, TextureKey> keys;          // par nom de fichier, chaque image hachée une fois
+        std::vector<TextureKey> textures;                // références tenues, une par image distincte
+    };
+
+    TextureKey textureKey(SceneObject& obj, const Surfaces& s);
+    TextureStreamer::Handle requestTexture(const Objx& objx, const Surfaces& s, TextureKey key);
+    const TextureRef* acquireTexture(SceneObject& obj, const Surfaces& s);
+    void releaseObject(SceneObject& obj);
+    void releaseHandle(TextureStreamer::Handle h);
+    void buildAtlas(const std::vector<std::unique_ptr<SceneObject>>& nouveaux);
+    void buildBatches(SceneObject& obj);
+    void rebuildBvh();
+
+    TextureStreamer& textures;
+    GpuMeshCache& meshes;
+    std::vector<std::unique_ptr<SceneObject>> objects;
+    std::map<TextureKey, TextureRef> textureRefs;
+    std::map<TextureKey, Blob> encoded; // octets de l'image de chaque clé attribuée ; vide : rendue, garde la chaîne
+    std::map<TextureStreamer::Handle, unsigned> handleRefs; // TextureRef par handle (plusieurs par page d'atlas)
+    Bvh bvh;                      // sur les boîtes des objets, reconstruite à chaque ajout
+    std::vector<size_t> visibles; // indices dans objects, réutilisé d'une frame à l'autre
+};
@@ -0,0 +1,180 @@
+// texture.cpp
+#include "texture.hpp"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+static bool surfaceToRGBA(SDL_Surface* surface, ImageRGBA& out) {
+    if (!surface) {
+        cerr << "Erreur chargement texture : " << IMG_GetError() << endl;
+        return false;
+    }
+    SDL_Surface* rgba = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+    SDL_FreeSurface(surface);
+    if (!rgba) {
+        cerr << "Erreur conversion texture : " << SDL_GetError() << endl;
+        return false;
+    }
+
+    out.w = rgba->w;
+    out.h = rgba->h;
+    out.pixels.resize((size_t)out.w * out.h * 4);
+    const unsigned char* src = static_cast<const unsigned char*>(rgba->pixels);
+    for (int y = 0; y < out.h; ++y) {
+        memcpy(&out.pixels[(size_t)y * out.w * 4], src + (size_t)y * rgba->pitch, (size_t)out.w * 4);
+    }
+    SDL_FreeSurface(rgba);
+    return true;
+}
+
+bool decodeImage(const Blob& png, ImageRGBA& out) {
+    return surfaceToRGBA(IMG_Load_RW(SDL_RWFromConstMem(png.data, (int)png.size), 1), out);
+}
+
+bool decodeImageFile(const string& filename, ImageRGBA& out) {
+    return surfaceToRGBA(IMG_Load(filename.c_str()), out);
+}
+
+static int nearestPowerOfTwo(int n) {
+    int p = 1;
+    while (p * 2 <= n) p *= 2;
+    return (n - p < p * 2 - n) ? p : p * 2; // plus proche en valeur absolue
+}
+
+ImageRGBA resizeToPowerOfTwo(const ImageRGBA& img) {
+    int w = nearestPowerOfTwo(img.w);
+    int h = nearestPowerOfTwo(img.h);
+    if (w == img.w && h == img.h) return img;
+
+    // Rééchantillonnage bilinéaire
+    ImageRGBA out;
+    out.w = w;
+    out.h = h;
+    out.pixels.resize((size_t)w * h * 4);
+    float sx = (float)img.w / w, sy = (float)img.h / h;
+    for (int y = 0; y < h; ++y) {
+        float fy = max(0.0f, (y + 0.5f) * sy - 0.5f);
+        int y0 = min((int)fy, img.h - 1), y1 = min(y0 + 1, img.h - 1);
+        float ty = fy - y0;
+        for (int x = 0; x < w; ++x) {
+            float fx = max(0.0f, (x + 0.5f) * sx - 0.5f);
+            int x0 = min((int)fx, img.w - 1), x1 = min(x0 + 1, img.w - 1);
+            float tx = fx - x0;
+            const unsigned char* p00 = &img.pixels[((size_t)y0 * img.w + x0) * 4];
+            const unsigned char* p10 = &img.pixels[((size_t)y0 * img.w + x1) * 4];
+            const unsigned char* p01 = &img.pixels[((size_t)y1 * img.w + x0) * 4];
+            const unsigned char* p11 = &img.pixels[((size_t)y1 * img.w + x1) * 4];
+            unsigned char* d = &out.pixels[((size_t)y * w + x) * 4];
+            for (int c = 0; c < 4; ++c) {
+                float top = p00[c] + (p10[c] - p00[c]) * tx;
+                float bottom = p01[c] + (p11[c] - p01[c]) * tx;
+                d[c] = (unsigned char)lroundf(top + (bottom - top) * ty);
+            }
+        }
+    }
+    return out;
+}
+
+MipChain buildMipChain(ImageRGBA&& base) {
+    MipChain chain;
+    chain.levels.push_back(std::move(base));
+    while (chain.levels.back().w > 1 || chain.levels.back().h > 1) {
+        const ImageRGBA& src = chain.levels.back();
+        ImageRGBA dst;
+        dst.w = max(1, src.w / 2);
+        dst.h = max(1, src.h / 2);
+        dst.pixels.resize((size_t)dst.w * dst.h * 4);
+        for (int y = 0; y < dst.h; ++y) {
+            int y0 = min(y * 2, src.h - 1), y1 = min(y * 2 + 1, src.h - 1);
+            const unsigned char* r0 = &src.pixels[(size_t)y0 * src.w * 4];
+            const unsigned char* r1 = &src.pixels[(size_t)y1 * src.w * 4];
+            unsigned char* d = &dst.pixels[(size_t)y * dst.w * 4];
+            for (int x = 0; x < dst.w; ++x) {
+                int x0 = min(x * 2, src.w - 1) * 4, x1 = min(x * 2 + 1, src.w - 1) * 4;
+                for (int c = 0; c < 4; ++c) {
+                    d[x * 4 + c] = (unsigned char)((r0[x0 + c] + r0[x1 + c] + r1[x0 + c] + r1[x1 + c] + 2) / 4);
+                }
+            }
+        }
+        chain.levels.push_back(std::move(dst));
+    }
+    return chain;
+}
+
+GLuint uploadTexture(const ImageRGBA& img) {
+    GLuint texID;
+    glGenTextures(1, &texID);
+    glBindTexture(GL_TEXTURE_2D, texID);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, img.w, img.h, 0, GL_RGBA, GL_UNSIGNED_BYTE, img.pixels.data());
+    return texID;
+}
+
+static const size_t RAW_TEXTURE_HEADER = 16, RAW_TEXTURE_LEVEL = 16, RAW_TEXTURE_ALIGN = 16;
+
+static void putU32(vector<unsigned char>& out, size_t at, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out[at + i] = (unsigned char)(v >> (8 * i));
+}
+
+static uint32_t getU32(const unsigned char* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+vector<unsigned char> writeRawTexture(const MipChain& chain) {
+    size_t offset = RAW_TEXTURE_HEADER + chain.levels.size() * RAW_TEXTURE_LEVEL;
+    vector<size_t> offsets;
+    for (const auto& lvl : chain.levels) {
+        offset = (offset + RAW_TEXTURE_ALIGN - 1) & ~(RAW_TEXTURE_ALIGN - 1);
+        offsets.push_back(offset);
+        offset += lvl.pixels.size();
+    }
+
+    vector<unsigned char> out(offset, 0);
+    memcpy(out.data(), RAW_TEXTURE_MAGIC, 4);
+    putU32(out, 4, RAW_TEXTURE_VERSION);
+    putU32(out, 8, (uint32_t)chain.levels.size());
+    for (size_t i = 0; i < chain.levels.size(); ++i) {
+        const ImageRGBA& lvl = chain.levels[i];
+        size_t at = RAW_TEXTURE_HEADER + i * RAW_TEXTURE_LEVEL;
+        putU32(out, at, (uint32_t)lvl.w);
+        putU32(out, at + 4, (uint32_t)lvl.h);
+        putU32(out, at + 8, (uint32_t)offsets[i]);
+        putU32(out, at + 12, (uint32_t)lvl.pixels.size());
+        memcpy(&out[offsets[i]], lvl.pixels.data(), lvl.pixels.size());
+    }
+    return out;
+}
+
+bool readRawTexture(const Blob& blob, vector<RawTextureLevel>& out) {
+    if (blob.size < RAW_TEXTURE_HEADER || memcmp(blob.data, RAW_TEXTURE_MAGIC, 4) != 0) return false;
+    if (getU32(blob.data + 4) != RAW_TEXTURE_VERSION) return false;
+    size_t count = getU32(blob.data + 8);
+    if (count == 0 || RAW_TEXTURE_HEADER + count * RAW_TEXTURE_LEVEL > blob.size) return false;
+
+    out.clear();
+    for (size_t i = 0; i < count; ++i) {
+        const unsigned char* e = blob.data + RAW_TEXTURE_HEADER + i * RAW_TEXTURE_LEVEL;
+        RawTextureLevel lvl;
+        lvl.w = (int)getU32(e);
+        lvl.h = (int)getU32(e + 4);
+        size_t offset = getU32(e + 8), size = getU32(e + 12);
+        if (lvl.w <= 0 || lvl.h <= 0 || size != (size_t)lvl.w * lvl.h * 4 || offset + size > blob.size) return false;
+        lvl.pixels = blob.slice(offset, size);
+        out.push_back(std::move(lvl));
+    }
+    return true;
+}
+
+string rawTextureEntryName(const string& textureName) {
+    return textureName + ".rgba";
+}
@@ -0,0 +1,45 @@
+// texture.hpp
+#pragma once
+#include "archive.hpp"
+#include <SDL2/SDL_opengles2.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Image décodée en RGBA 8 bits, prête pour glTexImage2D
+struct ImageRGBA {
+    int w = 0, h = 0;
+    std::vector<unsigned char> pixels; // w * h * 4 octets, lignes contiguës
+};
+
+// Chaîne de mipmaps calculée sur le CPU, niveau 0 en premier
+struct MipChain {
+    std::vector<ImageRGBA> levels;
+};
+
+// Réduit l'image aux dimensions puissances de 2 les plus proches (mipmaps GLES2 sans GL_OES_texture_npot)
+ImageRGBA resizeToPowerOfTwo(const ImageRGBA& img);
+// Filtre boîte 2x2 successif jusqu'à 1x1
+MipChain buildMipChain(ImageRGBA&& base);
+
+// Décodage PNG sans appel GL : utilisable depuis n'importe quel thread
+bool decodeImage(const Blob& png, ImageRGBA& out);
+bool decodeImageFile(const std::string& filename, ImageRGBA& out);
+
+// Texture pré-décodée du profil d'archive aligné ("ground.png" -> "ground.png.rgba"), petit-boutiste :
+//   "ORGB", version, nombre de niveaux, réservé, puis par niveau : largeur, hauteur, offset, taille
+//   Les pixels RGBA de chaque niveau commencent à un offset multiple de 16 dans l'entrée.
+constexpr char RAW_TEXTURE_MAGIC[4] = {'O', 'R', 'G', 'B'};
+constexpr uint32_t RAW_TEXTURE_VERSION = 1;
+
+struct RawTextureLevel {
+    int w = 0, h = 0;
+    Blob pixels; // vue dans l'entrée : aucune copie quand l'archive est projetée par mmap
+};
+
+std::vector<unsigned char> writeRawTexture(const MipChain& chain);
+bool readRawTexture(const Blob& blob, std::vector<RawTextureLevel>& out);
+std::string rawTextureEntryName(const std::string& textureName);
+
+// Envoi GL en un bloc, sans mipmaps : uniquement sur le thread qui possède le contexte
+GLuint uploadTexture(const ImageRGBA& img);
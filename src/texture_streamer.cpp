@@ -0,0 +1,266 @@
+// texture_streamer.cpp
+#include "texture_streamer.hpp"
+#include "etc1.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+// Taille max de l'aperçu envoyé d'un coup dès la fin du décodage
+static const int PREVIEW_SIZE = 64;
+
+static void setTrilinear() {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+static GLuint newTexture() {
+    GLuint tex;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    setTrilinear();
+    return tex;
+}
+
+TextureStreamer::TextureStreamer(ThreadPool& pool) : pool(pool) {
+    const char* ext = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+    npotMipmaps = ext && strstr(ext, "GL_OES_texture_npot");
+    etc1 = ext && strstr(ext, "GL_OES_compressed_ETC1_RGB8_texture");
+
+    const unsigned char gris[4] = {200, 200, 200, 255};
+    glGenTextures(1, &placeholder);
+    glBindTexture(GL_TEXTURE_2D, placeholder);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, gris);
+}
+
+bool TextureStreamer::fromImage(ImageRGBA&& img, bool npot, Payload& out) {
+    if (img.w <= 0) return false;
+    MipChain mips = buildMipChain(npot ? std::move(img) : resizeToPowerOfTwo(img));
+    out.format = GL_RGBA;
+    for (auto& lvl : mips.levels) out.color.push_back({lvl.w, lvl.h, Blob::fromVector(std::move(lvl.pixels))});
+    return true;
+}
+
+TextureStreamer::Handle TextureStreamer::submit(function<bool(Payload&)> produce) {
+    uint32_t index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        index = (uint32_t)slots.size();
+        slots.emplace_back();
+    }
+    slots[index].used = true;
+    incomplete.push_back(index);
+    Handle h = slots[index].generation << SLOT_BITS | index;
+
+    auto box = inbox;
+    pool.submit([box, h, produce]() {
+        PROFILE_SCOPE("texture decode");
+        Decoded d{h, {}};
+        if (!produce(d.payload)) d.payload = Payload();
+        lock_guard<mutex> lock(box->mutex);
+        box->ready.push_back(std::move(d));
+    });
+    return h;
+}
+
+TextureStreamer::Slot* TextureStreamer::slotOf(Handle h) {
+    return const_cast<Slot*>(static_cast<const TextureStreamer*>(this)->slotOf(h));
+}
+
+const TextureStreamer::Slot* TextureStreamer::slotOf(Handle h) const {
+    uint32_t index = h & ((1u << SLOT_BITS) - 1);
+    if (index >= slots.size()) return nullptr;
+    const Slot& slot = slots[index];
+    return slot.used && slot.generation == h >> SLOT_BITS ? &slot : nullptr;
+}
+
+// Textures GL supprimées, place rendue avec une nouvelle génération
+void TextureStreamer::freeSlot(uint32_t index) {
+    Slot& slot = slots[index];
+    GLuint ids[4] = {slot.shown, slot.shownAlpha, slot.building, slot.buildingAlpha};
+    for (GLuint id : ids) if (id) glDeleteTextures(1, &id);
+    Handle generation = (slot.generation + 1) & ((1u << (32 - SLOT_BITS)) - 1);
+    slot = Slot();
+    slot.generation = generation;
+    freeSlots.push_back(index);
+}
+
+TextureStreamer::Handle TextureStreamer::request(const Blob& png, const Blob* etc1Blob, const Blob* rawBlob) {
+    Blob compressed = (etc1 && etc1Blob) ? *etc1Blob : Blob();
+    Blob raw = rawBlob ? *rawBlob : Blob();
+    bool npot = npotMipmaps;
+    return submit([png, compressed, raw, npot](Payload& out) {
+        Etc1Texture tex;
+        if (!compressed.empty() && readEtc1Container(compressed, tex)) {
+            out.format = GL_ETC1_RGB8_OES;
+            for (auto& lvl : tex.levels) {
+                out.color.push_back({lvl.w, lvl.h, Blob::fromVector(std::move(lvl.color))});
+                if (tex.hasAlpha) out.alpha.push_back({lvl.w, lvl.h, Blob::fromVector(std::move(lvl.alpha))});
+            }
+            return true;
+        }
+        vector<RawTextureLevel> levels;
+        if (!raw.empty() && readRawTexture(raw, levels)) {
+            out.format = GL_RGBA; // déjà en puissances de 2 avec ses mipmaps : ni décodage ni copie
+            for (auto& lvl : levels) out.color.push_back({lvl.w, lvl.h, lvl.pixels});
+            return true;
+        }
+        ImageRGBA img;
+        return decodeImage(png, img) && fromImage(std::move(img), npot, out);
+    });
+}
+
+TextureStreamer::Handle TextureStreamer::requestImage(function<bool(ImageRGBA&)> produce) {
+    bool npot = npotMipmaps;
+    return submit([produce, npot](Payload& out) {
+        ImageRGBA img;
+        return produce(img) && fromImage(std::move(img), npot, out);
+    });
+}
+
+GLuint TextureStreamer::glTexture(Handle h) const {
+    const Slot* slot = slotOf(h);
+    return slot && slot->shown ? slot->shown : placeholder;
+}
+
+GLuint TextureStreamer::glAlphaTexture(Handle h) const {
+    const Slot* slot = slotOf(h);
+    return slot && slot->shown ? slot->shownAlpha : 0;
+}
+
+void TextureStreamer::uploadLevel(GLenum format, GLint level, const Level& l) {
+    PROFILE_COUNT(Counter::BytesUploaded, l.bytes.size);
+    if (format == GL_RGBA) {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, l.w, l.h, 0, GL_RGBA, GL_UNSIGNED_BYTE, l.bytes.data);
+    } else {
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, format, l.w, l.h, 0, (GLsizei)l.bytes.size, l.bytes.data);
+    }
+}
+
+bool TextureStreamer::uploadSome(Slot& slot, size_t& budget) {
+    const Payload& p = slot.payload;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    while (slot.level >= 0) {
+        const Level& lvl = p.color[slot.level];
+        glBindTexture(GL_TEXTURE_2D, slot.building);
+        if (p.format != GL_RGBA) {
+            // Les niveaux compressés ne peuvent pas être envoyés par bandes : un niveau entier par étape
+            uploadLevel(p.format, slot.level, lvl);
+            size_t bytes = lvl.bytes.size;
+            if (!p.alpha.empty()) {
+                glBindTexture(GL_TEXTURE_2D, slot.buildingAlpha);
+                uploadLevel(p.format, slot.level, p.alpha[slot.level]);
+                bytes *= 2;
+            }
+            budget -= min(budget, bytes);
+            slot.level--;
+        } else {
+            size_t rowBytes = (size_t)lvl.w * 4;
+            if (slot.row == 0) {
+                glTexImage2D(GL_TEXTURE_2D, slot.level, GL_RGBA, lvl.w, lvl.h, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            }
+            // Au moins une ligne par frame pour toujours avancer, même avec un budget épuisé
+            int rows = (int)min<size_t>(lvl.h - slot.row, max<size_t>(1, budget / rowBytes));
+            glTexSubImage2D(GL_TEXTURE_2D, slot.level, 0, slot.row, lvl.w, rows, GL_RGBA, GL_UNSIGNED_BYTE,
+                            lvl.bytes.data + slot.row * rowBytes);
+            PROFILE_COUNT(Counter::BytesUploaded, rows * rowBytes);
+            budget -= min(budget, rows * rowBytes);
+            slot.row += rows;
+            if (slot.row == lvl.h) {
+                slot.row = 0;
+                slot.level--;
+            }
+        }
+        if (budget == 0) break;
+    }
+    return slot.level < 0;
+}
+
+void TextureStreamer::update(size_t budgetBytes) {
+    PROFILE_SCOPE("texture upload");
+    vector<Decoded> ready;
+    {
+        lock_guard<mutex> lock(inbox->mutex);
+        ready.swap(inbox->ready);
+    }
+
+    for (auto& d : ready) {
+        Slot* found = slotOf(d.handle);
+        if (!found) continue; // libéré (ou clear()) pendant le décodage, place peut-être déjà réutilisée
+        Slot& slot = *found;
+        if (d.payload.color.empty()) {
+            slot.complete = true; // décodage raté : le substitut reste
+            continue;
+        }
+        slot.payload = std::move(d.payload);
+        const Payload& p = slot.payload;
+
+        // Aperçu : les petits niveaux forment une texture complète, envoyée tout de suite
+        size_t first = 0;
+        while (first + 1 < p.color.size() && max(p.color[first].w, p.color[first].h) > PREVIEW_SIZE) ++first;
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        slot.shown = newTexture();
+        for (size_t l = first; l < p.color.size(); ++l) uploadLevel(p.format, (GLint)(l - first), p.color[l]);
+        if (!p.alpha.empty()) {
+            slot.shownAlpha = newTexture();
+            for (size_t l = first; l < p.alpha.size(); ++l) uploadLevel(p.format, (GLint)(l - first), p.alpha[l]);
+        }
+
+        if (first == 0) { // déjà la texture complète
+            slot.payload = Payload();
+            slot.complete = true;
+            continue;
+        }
+        slot.building = newTexture();
+        if (!p.alpha.empty()) slot.buildingAlpha = newTexture();
+        slot.level = (int)p.color.size() - 1;
+        slot.row = 0;
+    }
+
+    // Seules les places incomplètes sont parcourues ; celles terminées sortent de la liste
+    size_t budget = budgetBytes;
+    size_t garde = 0;
+    for (uint32_t index : incomplete) {
+        Slot& slot = slots[index];
+        if (!slot.complete && slot.building && budget > 0 && uploadSome(slot, budget)) {
+            glDeleteTextures(1, &slot.shown);
+            if (slot.shownAlpha) glDeleteTextures(1, &slot.shownAlpha);
+            slot.shown = slot.building;
+            slot.shownAlpha = slot.buildingAlpha;
+            slot.building = slot.buildingAlpha = 0;
+            slot.payload = Payload();
+            slot.complete = true;
+        }
+        if (!slot.complete) incomplete[garde++] = index;
+    }
+    incomplete.resize(garde);
+}
+
+void TextureStreamer::release(Handle h) {
+    Slot* slot = slotOf(h);
+    if (!slot) return;
+    uint32_t index = (uint32_t)(slot - slots.data());
+    if (!slot->complete) incomplete.erase(find(incomplete.begin(), incomplete.end(), index));
+    freeSlot(index);
+}
+
+size_t TextureStreamer::pending() const {
+    return incomplete.size();
+}
+
+void TextureStreamer::clear() {
+    // Les places restent, avec leur génération : un décodage parti avant ne retrouvera pas la sienne
+    freeSlots.clear();
+    for (uint32_t i = 0; i < slots.size(); ++i) freeSlot(i);
+    incomplete.clear();
+    if (placeholder) glDeleteTextures(1, &placeholder);
+    placeholder = 0;
+}
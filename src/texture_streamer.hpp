@@ -0,0 +1,80 @@
+// texture_streamer.hpp
+#pragma once
+#include "texture.hpp"
+#include "thread_pool.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Textures décodées hors du thread GL puis envoyées par morceaux sous un budget par frame.
+// Une surface affiche d'abord un substitut, puis un aperçu basse résolution, puis la texture complète
+// (filtrage trilinéaire). Quand le pilote gère ETC1 et que l'archive en contient une version,
+// elle est envoyée telle quelle au lieu de décoder le PNG ; à défaut, une version pré-décodée (profil
+// d'archive aligné) est envoyée directement depuis l'archive projetée.
+class TextureStreamer {
+public:
+    using Handle = uint32_t;
+
+    explicit TextureStreamer(ThreadPool& pool); // thread GL : crée le substitut
+
+    Handle request(const Blob& png, const Blob* etc1 = nullptr, const Blob* raw = nullptr); // PNG déjà en mémoire
+    Handle requestImage(std::function<bool(ImageRGBA&)> produce); // image produite sur le pool (page d'atlas)
+
+    void release(Handle h);                    // libère les textures GL et la place ; un décodage en cours est ignoré à l'arrivée
+    GLuint glTexture(Handle h) const;          // substitut tant que rien n'est prêt
+    GLuint glAlphaTexture(Handle h) const;     // plan alpha séparé (ETC1), 0 sinon
+    void update(size_t budgetBytes);           // thread GL, une fois par frame
+    size_t pending() const;                    // textures pas encore complètes
+    bool supportsEtc1() const { return etc1; }
+    void clear();
+
+private:
+    struct Level {
+        int w = 0, h = 0;
+        Blob bytes; // pixels RGBA ou blocs ETC1, éventuellement pointés dans l'archive projetée
+    };
+    struct Payload { // niveaux prêts pour le GPU, niveau 0 en premier
+        GLenum format = GL_RGBA;
+        std::vector<Level> color;
+        std::vector<Level> alpha; // ETC1 avec transparence uniquement
+    };
+    struct Decoded {
+        Handle handle;
+        Payload payload;
+    };
+    struct Inbox { // partagé avec les tâches du pool, qui peuvent survivre au streamer
+        std::mutex mutex;
+        std::vector<Decoded> ready;
+    };
+    struct Slot {
+        GLuint shown = 0, shownAlpha = 0;       // textures actuellement utilisées pour dessiner
+        GLuint building = 0, buildingAlpha = 0; // textures complètes en cours d'envoi
+        Payload payload;
+        int level = -1;       // niveau en cours d'envoi dans building (du plus petit au niveau 0)
+        int row = 0;          // prochaine ligne de ce niveau (RGBA seulement)
+        bool complete = false;
+        bool used = false;    // false : dans freeSlots
+        Handle generation = 0; // incrémentée à chaque libération : un vieux handle ne désigne plus rien
+    };
+    // Handle = génération << SLOT_BITS | place ; les places libérées sont réutilisées
+    static const int SLOT_BITS = 20;
+    Handle submit(std::function<bool(Payload&)> produce);
+    Slot* slotOf(Handle h);
+    const Slot* slotOf(Handle h) const;
+    void freeSlot(uint32_t index);
+    static bool fromImage(ImageRGBA&& img, bool npot, Payload& out);
+    static void uploadLevel(GLenum format, GLint level, const Level& l);
+    bool uploadSome(Slot& slot, size_t& budget);
+
+    ThreadPool& pool;
+    std::shared_ptr<Inbox> inbox = std::make_shared<Inbox>();
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;  // places réutilisables
+    std::vector<uint32_t> incomplete; // places pas encore complètes : seules parcourues par update
+    GLuint placeholder = 0;
+    bool npotMipmaps = false;
+    bool etc1 = false;
+};
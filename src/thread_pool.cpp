@@ -0,0 +1,50 @@
+// thread_pool.cpp
+#include "thread_pool.hpp"
+#include <cstdlib>
+
+using namespace std;
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) threads = defaultThreadCount();
+    for (unsigned i = 0; i < threads; ++i) workers.emplace_back([this]() { run(); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    for (auto& t : workers) t.join();
+}
+
+unsigned ThreadPool::defaultThreadCount() {
+    if (const char* env = getenv("ORIGAMIX_THREADS")) {
+        int n = atoi(env);
+        if (n > 0) return (unsigned)n;
+    }
+    unsigned n = thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
+void ThreadPool::enqueue(function<void()> job) {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    cv.notify_one();
+}
+
+void ThreadPool::run() {
+    for (;;) {
+        function<void()> job;
+        {
+            unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if (jobs.empty()) return; // stopping et plus rien à faire
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
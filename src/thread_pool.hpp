@@ -0,0 +1,43 @@
+// thread_pool.hpp
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool de threads de travail à file unique (FIFO)
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads = 0); // 0 = nombre de cœurs
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <class F>
+    auto submit(F&& f) -> std::future<decltype(f())> {
+        using R = decltype(f());
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+        std::future<R> result = task->get_future();
+        enqueue([task]() { (*task)(); });
+        return result;
+    }
+
+    unsigned size() const { return (unsigned)workers.size(); }
+
+    // Nombre de threads par défaut : ORIGAMIX_THREADS si défini, sinon le nombre de cœurs
+    static unsigned defaultThreadCount();
+
+private:
+    void enqueue(std::function<void()> job);
+    void run();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+};
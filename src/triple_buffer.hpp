@@ -0,0 +1,35 @@
+// triple_buffer.hpp
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Passage d'un état d'un producteur à un consommateur, sans verrou ni attente : trois copies.
+// Le producteur remplit back() puis publish() l'échange avec la copie du milieu ; le consommateur,
+// par update(), échange la sienne avec celle du milieu si elle est neuve. Seul le dernier état
+// publié compte : ceux que le consommateur n'a pas eu le temps de lire sont perdus.
+template <typename T>
+class TripleBuffer {
+public:
+    T& back() { return slots[backIndex]; } // producteur uniquement
+
+    void publish() {
+        uint8_t ancien = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel);
+        backIndex = ancien & INDEX;
+    }
+
+    // Consommateur : true si un état a été publié depuis le dernier appel
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        uint8_t ancien = middle.exchange(frontIndex, std::memory_order_acq_rel);
+        frontIndex = ancien & INDEX;
+        return true;
+    }
+
+    const T& front() const { return slots[frontIndex]; } // consommateur uniquement
+
+private:
+    static constexpr uint8_t INDEX = 3, FRESH = 4;
+    T slots[3] = {};
+    uint8_t backIndex = 0, frontIndex = 1;
+    std::atomic<uint8_t> middle{2};
+};
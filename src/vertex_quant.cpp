@@ -0,0 +1,62 @@
+// vertex_quant.cpp
+#include "vertex_quant.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+static const float UNORM16_MAX = 65535.0f;
+
+static uint16_t quantizeComponent(float value, float min, float extent) {
+    float q = (value - min) / extent * UNORM16_MAX;
+    return (uint16_t)lrintf(std::min(std::max(q, 0.0f), UNORM16_MAX));
+}
+
+Dequantization Dequantization::of(const vector<Point5D>& points) {
+    Dequantization d;
+    if (points.empty()) return d;
+    float lo[5], hi[5];
+    for (int c = 0; c < 5; ++c) lo[c] = INFINITY, hi[c] = -INFINITY;
+    for (const auto& p : points) {
+        const float v[5] = {p.x, p.y, p.z, p.u, p.v};
+        for (int c = 0; c < 5; ++c) {
+            lo[c] = std::min(lo[c], v[c]);
+            hi[c] = std::max(hi[c], v[c]);
+        }
+    }
+    for (int c = 0; c < 5; ++c) {
+        float& min = c < 3 ? d.posMin[c] : d.uvMin[c - 3];
+        float& extent = c < 3 ? d.posExtent[c] : d.uvExtent[c - 3];
+        min = lo[c];
+        extent = hi[c] > lo[c] ? hi[c] - lo[c] : 1.0f; // axe plat (z des sprites) : q = 0, exact
+    }
+    return d;
+}
+
+float Dequantization::maxError(int component) const {
+    float extent = component < 3 ? posExtent[component] : uvExtent[component - 3];
+    return extent / (2 * UNORM16_MAX);
+}
+
+vector<PackedVertex> quantize(const vector<Point5D>& points, const Dequantization& d) {
+    vector<PackedVertex> out(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        const Point5D& p = points[i];
+        PackedVertex& q = out[i];
+        q.x = quantizeComponent(p.x, d.posMin[0], d.posExtent[0]);
+        q.y = quantizeComponent(p.y, d.posMin[1], d.posExtent[1]);
+        q.z = quantizeComponent(p.z, d.posMin[2], d.posExtent[2]);
+        q.pad = 0;
+        q.u = quantizeComponent(p.u, d.uvMin[0], d.uvExtent[0]);
+        q.v = quantizeComponent(p.v, d.uvMin[1], d.uvExtent[1]);
+    }
+    return out;
+}
+
+Point5D dequantize(const PackedVertex& q, const Dequantization& d) {
+    return {d.posMin[0] + q.x / UNORM16_MAX * d.posExtent[0],
+            d.posMin[1] + q.y / UNORM16_MAX * d.posExtent[1],
+            d.posMin[2] + q.z / UNORM16_MAX * d.posExtent[2],
+            d.uvMin[0] + q.u / UNORM16_MAX * d.uvExtent[0],
+            d.uvMin[1] + q.v / UNORM16_MAX * d.uvExtent[1]};
+}
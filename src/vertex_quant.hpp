@@ -0,0 +1,28 @@
+// vertex_quant.hpp
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "objx.hpp"
+
+// Sommets compacts : position et UV en entiers 16 bits normalisés, relatifs à la boîte des points
+// de la surface (12 octets au lieu des 20 de Point5D). Reconstruction : p = min + q / 65535 * extent,
+// faite par le vertex shader (uniformes) ou par dequantize. Erreur d'arrondi au plus extent / 131070
+// par axe : 1/64 de pixel pour un sprite de 2048, 1/64 de texel pour une page d'atlas de 2048.
+struct PackedVertex {
+    uint16_t x, y, z, pad; // pad : UV alignées sur 4 octets pour le GPU
+    uint16_t u, v;
+};
+
+struct Dequantization {
+    float posMin[3] = {0, 0, 0}, posExtent[3] = {1, 1, 1};
+    float uvMin[2] = {0, 0}, uvExtent[2] = {1, 1};
+
+    static Dequantization of(const std::vector<Point5D>& points); // boîte des points ; étendue nulle -> 1
+    float maxError(int component) const; // x, y, z, u, v
+};
+
+static_assert(sizeof(PackedVertex) == 12, "PackedVertex doit rester compact");
+static_assert(sizeof(Dequantization) == 10 * sizeof(float), "stocké tel quel dans le meshb");
+
+std::vector<PackedVertex> quantize(const std::vector<Point5D>& points, const Dequantization& d);
+Point5D dequantize(const PackedVertex& q, const Dequantization& d);
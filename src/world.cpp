@@ -0,0 +1,263 @@
+// world.cpp
+#include "world.hpp"
+#include "etc1.hpp"
+#include "texture.hpp"
+#include "profiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const char* INDEX_NAME = "world.index";
+static const float LOAD_MARGIN = 0.5f; // en tailles de chunk : lu un peu avant d'entrer à l'écran
+static const float KEEP_MARGIN = 1.5f; // plus large : un aller-retour de la vue ne recharge pas tout
+static const size_t MAX_LOADS_IN_FLIGHT = 4; // le reste du pool garde la main pour les textures
+
+bool WorldIndex::read(const string& directory) {
+    ifstream in(fs::path(directory) / INDEX_NAME);
+    if (!in) return false;
+    chunks.clear();
+    string line;
+    while (getline(in, line)) {
+        istringstream l(line);
+        string mot;
+        l >> mot;
+        if (mot == "chunk_size") {
+            l >> chunkSize;
+        } else if (mot == "chunk") {
+            WorldChunk c;
+            l >> c.cx >> c.cy;
+            for (float& v : c.bounds.min) l >> v;
+            for (float& v : c.bounds.max) l >> v;
+            l >> c.file;
+            if (!l || c.file.empty()) {
+                cerr << "[world] ligne illisible dans " << directory << " : " << line << endl;
+                continue;
+            }
+            chunks.push_back(std::move(c));
+        }
+    }
+    return chunkSize > 0;
+}
+
+bool WorldIndex::write(const string& directory) const {
+    // Écrit à côté puis renommé : un viewer qui lit l'index ne le voit jamais à moitié
+    fs::path path = fs::path(directory) / INDEX_NAME;
+    fs::path tmp = path.string() + ".tmp";
+    {
+        ofstream out(tmp);
+        if (!out) return false;
+        out << "chunk_size " << chunkSize << "\n";
+        for (const auto& c : chunks) {
+            out << "chunk " << c.cx << " " << c.cy;
+            for (float v : c.bounds.min) out << " " << v;
+            for (float v : c.bounds.max) out << " " << v;
+            out << " " << c.file << "\n";
+        }
+        if (!out) return false;
+    }
+    error_code ec;
+    fs::rename(tmp, path, ec);
+    return !ec;
+}
+
+// Nom libre dans le chunk pour cette texture : le même si absent ou identique, sinon suffixé de
+// l'empreinte (deux archives peuvent avoir chacune leur "sol.png")
+static string chunkTextureName(const Objx& chunk, const string& name, const Blob& png) {
+    const Blob* deja = chunk.getEmbedded(name);
+    if (!deja || (deja->size == png.size && memcmp(deja->data, png.data, png.size) == 0)) return name;
+    char empreinte[17];
+    snprintf(empreinte, sizeof(empreinte), "%016llx", (unsigned long long)hashBytes(png.data, png.size));
+    fs::path p(name);
+    return p.stem().string() + "_" + empreinte + p.extension().string();
+}
+
+bool buildWorld(const vector<PlacedObjx>& instances, float chunkSize, const string& directory, const SaveOptions& options) {
+    PROFILE_SCOPE("buildWorld");
+    if (chunkSize <= 0) return false;
+    map<pair<int, int>, Objx> cases;
+    for (const auto& inst : instances) {
+        Objx source = Objx::open(inst.path);
+        if (source.getEmplacement().empty()) {
+            cerr << "[world] archive illisible : " << inst.path << endl;
+            return false;
+        }
+        for (const auto& s : source.getSurfaces()) {
+            if (s.points.empty()) continue;
+            Surfaces placee = s;
+            for (auto& p : placee.points) {
+                p.x += inst.x;
+                p.y += inst.y;
+            }
+            Aabb box;
+            for (const auto& p : placee.points) box.extend(p);
+            pair<int, int> cell((int)floor((box.min[0] + box.max[0]) * 0.5f / chunkSize),
+                                (int)floor((box.min[1] + box.max[1]) * 0.5f / chunkSize));
+            auto it = cases.find(cell);
+            if (it == cases.end()) {
+                it = cases.emplace(cell, Objx()).first;
+                it->second.getSurfaces().clear();
+            }
+            Objx& chunk = it->second;
+
+            // Textures recopiées dans chaque chunk qui s'en sert, avec leurs versions ETC1 / pré-décodée
+            const Blob* png = placee.texture.empty() ? nullptr : source.getEmbedded(placee.texture);
+            if (png) {
+                string nom = chunkTextureName(chunk, placee.texture, *png);
+                chunk.embed(nom, *png);
+                if (const Blob* etc1 = source.getEmbedded(etc1EntryName(placee.texture))) chunk.embed(etc1EntryName(nom), *etc1);
+                if (const Blob* raw = source.getEmbedded(rawTextureEntryName(placee.texture))) chunk.embed(rawTextureEntryName(nom), *raw);
+                placee.texture = nom;
+            }
+            chunk.addSurface(placee);
+        }
+    }
+
+    error_code ec;
+    fs::create_directories(directory, ec);
+    if (ec) {
+        cerr << "[world] impossible de créer " << directory << " : " << ec.message() << endl;
+        return false;
+    }
+    WorldIndex index;
+    index.chunkSize = chunkSize;
+    for (auto& [cell, chunk] : cases) {
+        WorldChunk c;
+        c.cx = cell.first;
+        c.cy = cell.second;
+        c.file = "chunk_" + to_string(c.cx) + "_" + to_string(c.cy) + ".objx";
+        chunk.updateBounds();
+        c.bounds = chunk.getBounds();
+        chunk.setEmplacement((fs::path(directory) / c.file).string());
+        if (!chunk.save(options)) return false;
+        index.chunks.push_back(std::move(c));
+    }
+
+    // Chunks d'une construction précédente devenus vides
+    for (const auto& entry : fs::directory_iterator(directory)) {
+        string nom = entry.path().filename().string();
+        if (nom.rfind("chunk_", 0) != 0 || entry.path().extension() != ".objx") continue;
+        bool produit = any_of(index.chunks.begin(), index.chunks.end(), [&](const WorldChunk& c) { return c.file == nom; });
+        if (!produit) fs::remove(entry.path(), ec);
+    }
+    if (!index.write(directory)) return false;
+    cout << "[world] " << directory << " : " << instances.size() << " archive(s) en " << index.chunks.size()
+         << " chunk(s) de " << chunkSize << endl;
+    return true;
+}
+
+static Aabb expanded(const Aabb& b, float margin) {
+    Aabb e = b;
+    for (int i = 0; i < 3; ++i) {
+        e.min[i] -= margin;
+        e.max[i] += margin;
+    }
+    return e;
+}
+
+WorldStreamer::WorldStreamer(const string& directory, ThreadPool& pool, Scene& scene, size_t maxResident)
+    : pool(pool), scene(scene), maxResident(max<size_t>(1, maxResident)) {
+    if (!index.read(directory)) {
+        cerr << "[world] index illisible : " << directory << endl;
+        index.chunks.clear();
+        return;
+    }
+    vector<Aabb> boxes;
+    chunks.resize(index.chunks.size());
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        const WorldChunk& wc = index.chunks[i];
+        chunks[i].path = (fs::path(directory) / wc.file).string();
+        chunks[i].loadBox = expanded(wc.bounds, LOAD_MARGIN * index.chunkSize);
+        chunks[i].keepBox = expanded(wc.bounds, KEEP_MARGIN * index.chunkSize);
+        boxes.push_back(chunks[i].keepBox);
+    }
+    keepBvh.build(boxes);
+    cout << "[world] " << directory << " : " << chunks.size() << " chunk(s), " << this->maxResident
+         << " en mémoire au plus" << endl;
+}
+
+// Distance du centre projeté au centre de l'écran, en largeurs de fenêtre ; derrière l'œil = très loin
+float WorldStreamer::distanceToCenter(const Chunk& c, const ViewParams& view) const {
+    const Aabb& b = c.keepBox;
+    float clip[4];
+    projectPoint(view, (b.min[0] + b.max[0]) * 0.5f, (b.min[1] + b.max[1]) * 0.5f, (b.min[2] + b.max[2]) * 0.5f, clip);
+    if (clip[3] <= 0) return 1e30f;
+    return hypot(clip[0] / clip[3], clip[1] / clip[3]) / view.ndcExtent;
+}
+
+void WorldStreamer::evict(size_t i) {
+    int index = scene.indexOf(chunks[i].path);
+    if (index >= 0) scene.remove(index);
+    chunks[i].status = Status::Absent;
+    resident.erase(find(resident.begin(), resident.end(), i));
+}
+
+void WorldStreamer::update(const ViewParams& view) {
+    PROFILE_SCOPE("world streaming");
+    if (chunks.empty()) return;
+    ++frame;
+    proches.clear();
+    keepBvh.query(view, proches);
+    for (size_t i : proches) chunks[i].seen = frame;
+
+    // Lectures terminées : ajoutées si la vue est encore là, abandonnées sinon
+    for (auto it = loading.begin(); it != loading.end();) {
+        Chunk& c = chunks[*it];
+        if (c.objx.wait_for(chrono::seconds(0)) != future_status::ready) {
+            ++it;
+            continue;
+        }
+        Objx objx = c.objx.get();
+        if (objx.getEmplacement().empty()) {
+            cerr << "[world] chunk illisible, ignoré : " << c.path << endl;
+            c.status = Status::Failed;
+        } else if (c.seen == frame) {
+            scene.add(std::move(objx), true);
+            c.status = Status::Resident;
+            resident.push_back(*it);
+        } else {
+            c.status = Status::Absent;
+        }
+        it = loading.erase(it);
+    }
+
+    // Hors de keepBox : libéré tout de suite
+    for (size_t k = resident.size(); k-- > 0;) {
+        if (chunks[resident[k]].seen != frame) evict(resident[k]);
+    }
+
+    // À lire : entrés dans loadBox, du plus proche du centre au plus lointain
+    vector<pair<float, size_t>> voulus;
+    for (size_t i : proches) {
+        if (chunks[i].status == Status::Absent && isVisible(chunks[i].loadBox, view)) {
+            voulus.emplace_back(distanceToCenter(chunks[i], view), i);
+        }
+    }
+    sort(voulus.begin(), voulus.end());
+    for (const auto& [distance, i] : voulus) {
+        if (loading.size() >= MAX_LOADS_IN_FLIGHT) break;
+        if (resident.size() + loading.size() >= maxResident) {
+            // Budget plein : la place du chunk résident le plus lointain, s'il est plus loin que celui-ci
+            size_t loin = resident.size();
+            float dLoin = distance;
+            for (size_t k = 0; k < resident.size(); ++k) {
+                float d = distanceToCenter(chunks[resident[k]], view);
+                if (d > dLoin) dLoin = d, loin = k;
+            }
+            if (loin == resident.size()) break;
+            evict(resident[loin]);
+        }
+        string path = chunks[i].path;
+        chunks[i].objx = pool.submit([path]() { return Objx::open(path, ArchiveAccess::Copied); });
+        chunks[i].status = Status::Loading;
+        loading.push_back(i);
+    }
+}
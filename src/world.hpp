@@ -0,0 +1,82 @@
+// world.hpp
+#pragma once
+#include "culling.hpp"
+#include "objx.hpp"
+#include "scene.hpp"
+#include "thread_pool.hpp"
+#include <future>
+#include <string>
+#include <vector>
+
+// Monde découpé en chunks : un dossier "<nom>.world" qui contient un index texte et une archive Objx
+// par case occupée d'une grille régulière en x/y. Chaque archive porte ses surfaces, déjà placées, et
+// ses textures : elle s'ouvre seule. Une texture présente dans plusieurs chunks n'occupe qu'une
+// texture GPU (registre par contenu de Scene).
+//
+// world.index :
+//   chunk_size <taille>
+//   chunk <cx> <cy> <min x y z> <max x y z> <fichier>
+
+struct WorldChunk {
+    int cx = 0, cy = 0;
+    Aabb bounds;      // boîte des surfaces, qui peut déborder de la case
+    std::string file; // relatif au dossier du monde
+};
+
+struct WorldIndex {
+    float chunkSize = 1024.0f;
+    std::vector<WorldChunk> chunks;
+
+    bool read(const std::string& directory);
+    bool write(const std::string& directory) const;
+};
+
+// Archive posée dans le monde : ses surfaces décalées de (x, y)
+struct PlacedObjx {
+    std::string path;
+    float x = 0, y = 0;
+};
+
+// Chaque surface va dans la case qui contient le centre de sa boîte. Les chunks d'une construction
+// précédente qui ne sont plus produits sont supprimés. false si une archive est illisible ou si une
+// écriture échoue.
+bool buildWorld(const std::vector<PlacedObjx>& instances, float chunkSize, const std::string& directory,
+                const SaveOptions& options = SaveOptions());
+
+// Chunks ouverts sur le pool quand la vue s'en approche, retirés de la scène quand elle s'en éloigne.
+// Au plus maxResident chunks en mémoire (chargés ou en lecture), les plus proches du centre de l'écran
+// d'abord : la mémoire reste bornée quelle que soit la taille du monde.
+class WorldStreamer {
+public:
+    WorldStreamer(const std::string& directory, ThreadPool& pool, Scene& scene, size_t maxResident = 64);
+    WorldStreamer(const WorldStreamer&) = delete;
+    WorldStreamer& operator=(const WorldStreamer&) = delete;
+
+    bool valid() const { return !index.chunks.empty(); }
+    void update(const ViewParams& view); // thread GL, une fois par frame
+
+    size_t chunkCount() const { return index.chunks.size(); }
+    size_t residentCount() const { return resident.size(); }
+    size_t loadingCount() const { return loading.size(); }
+
+private:
+    enum class Status { Absent, Loading, Resident, Failed };
+    struct Chunk {
+        std::string path;
+        Aabb loadBox, keepBox; // bounds élargie : chargé en entrant dans loadBox, gardé tant que keepBox est visible
+        Status status = Status::Absent;
+        std::future<Objx> objx;
+        unsigned seen = 0; // dernière frame où keepBox était visible
+    };
+    float distanceToCenter(const Chunk& c, const ViewParams& view) const;
+    void evict(size_t chunk);
+
+    WorldIndex index;
+    ThreadPool& pool;
+    Scene& scene;
+    size_t maxResident;
+    std::vector<Chunk> chunks;
+    Bvh keepBvh; // sur les keepBox
+    std::vector<size_t> proches, loading, resident; // indices dans chunks, réutilisés d'une frame à l'autre
+    unsigned frame = 0;
+};
@@ -0,0 +1,69 @@
+// fillrate.cpp — remplissage perdu des surfaces d'archives Objx (make fillrate)
+//
+// Usage : origamix_fillrate [--heatmap dossier] archive.plxl...
+// Pour chaque archive : surfaces de la plus gaspilleuse à la moins, puis le classement des archives
+// par texels transparents couverts, pour savoir quels assets redécouper en premier.
+#include "fill_analysis.hpp"
+#include "objx.hpp"
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static void printStats(const char* label, const FillStats& s) {
+    printf("  %-32.32s %12llu %12llu %7.1f %%\n", label, (unsigned long long)s.covered,
+           (unsigned long long)s.transparent, 100.0 * s.wastedRatio());
+}
+
+int main(int argc, char** argv) {
+    string heatmapDir;
+    vector<string> archives;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--heatmap") && i + 1 < argc) heatmapDir = argv[++i];
+        else archives.push_back(argv[i]);
+    }
+    if (archives.empty()) {
+        cerr << "Usage : " << argv[0] << " [--heatmap dossier] archive.plxl..." << endl;
+        return 1;
+    }
+
+    IMG_Init(IMG_INIT_PNG);
+    vector<pair<string, FillStats>> classement;
+    for (const auto& path : archives) {
+        Objx px;
+        {
+            streambuf* out = cout.rdbuf(nullptr); // journaux de Objx::open
+            px = Objx::open(path);
+            cout.rdbuf(out);
+        }
+        string dir = heatmapDir.empty() ? "" : (fs::path(heatmapDir) / fs::path(path).stem()).string();
+        ObjxFill fill = analyzeObjx(px, dir);
+
+        sort(fill.surfaces.begin(), fill.surfaces.end(), [](const SurfaceFill& a, const SurfaceFill& b) {
+            return a.stats.wastedRatio() > b.stats.wastedRatio();
+        });
+        printf("%s\n  %-32s %12s %12s %9s\n", path.c_str(), "surface", "couverts", "transparents", "perdu");
+        for (const auto& s : fill.surfaces) {
+            string label = "#" + to_string(s.index) + " " + s.texture;
+            printStats(label.c_str(), s.stats);
+        }
+        printStats("total", fill.total);
+        classement.emplace_back(path, fill.total);
+    }
+
+    sort(classement.begin(), classement.end(), [](const auto& a, const auto& b) {
+        return a.second.transparent > b.second.transparent;
+    });
+    printf("\narchives, par texels transparents couverts\n");
+    for (const auto& [path, stats] : classement) printStats(fs::path(path).filename().string().c_str(), stats);
+    if (!heatmapDir.empty()) printf("\ncartes écrites dans %s\n", heatmapDir.c_str());
+    IMG_Quit();
+    return 0;
+}
@@ -0,0 +1,38 @@
+// worldbuild.cpp — découpe des archives Objx placées en monde à chunks (make world, voir world.hpp)
+//
+// Usage : origamix_worldbuild [--chunk taille] [--etc1] [--quantize] sortie.world archive[@x,y]...
+// Chaque archive est posée en (x, y), (0, 0) par défaut ; une même archive peut revenir plusieurs fois.
+#include "world.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    float chunkSize = 1024.0f;
+    SaveOptions options;
+    string sortie;
+    vector<PlacedObjx> instances;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--chunk") && i + 1 < argc) chunkSize = (float)atof(argv[++i]);
+        else if (!strcmp(argv[i], "--etc1")) options.etc1 = true;
+        else if (!strcmp(argv[i], "--quantize")) options.quantize = true;
+        else if (sortie.empty()) sortie = argv[i];
+        else {
+            PlacedObjx p;
+            p.path = argv[i];
+            size_t at = p.path.rfind('@');
+            if (at != string::npos && sscanf(p.path.c_str() + at + 1, "%f,%f", &p.x, &p.y) == 2) p.path.resize(at);
+            instances.push_back(p);
+        }
+    }
+    if (sortie.empty() || instances.empty() || chunkSize <= 0) {
+        cerr << "Usage : " << argv[0] << " [--chunk taille] [--etc1] [--quantize] sortie.world archive[@x,y]..." << endl;
+        return 1;
+    }
+    return buildWorld(instances, chunkSize, sortie, options) ? 0 : 1;
+}